@@ -1,19 +1,39 @@
 // ---- Strategy.hpp (drop-in for your template) --------------------------------
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <cmath>
 #include <cstdint>
-#include <map>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 using std::pair;
 using std::vector;
 
-class Strategy {
-public:
+// Types shared by every Strategy instantiation: prices, tunables, game
+// events and the book. Nothing here depends on the policy parameters.
+struct StrategyTypes {
+  // Fixed-point price: number of PRICE_TICK steps above 0. The book and order
+  // prices work in ticks; float prices only exist at the engine API.
+  using Tick = std::int16_t;
+  // Fair value, edges and the edge threshold are not on the price grid, so
+  // they are kept in hundredths of a tick: integer compares against book
+  // ticks, without moving the crossing point by up to half a tick.
+  using Fine = std::int32_t;
+  static constexpr Fine kFinePerTick = 100;
+
   // ───────── Tunables ─────────
   struct Cfg {
     // Risk / sizing
@@ -22,100 +42,1260 @@ public:
     static constexpr float POSITION_NUDGE_LATE = 0.25f; // fraction to shed late
 
     // Microstructure
-    static constexpr float MAX_SPREAD_TO_CROSS = 2.0f;  // price points
+    static constexpr Tick  MAX_SPREAD_TO_CROSS = 20;    // ticks (2.0 price points)
     static constexpr float PRICE_TICK = 0.1f;
-    static constexpr float PASSIVE_IMPROVE = 0.1f;      // improve best by one tick
+    static constexpr Tick  MAX_TICK = 1000;             // 100.0 / PRICE_TICK
+    static constexpr Tick  PASSIVE_IMPROVE = 1;         // improve best by one tick
     static constexpr float MIN_BOOK_QTY = 1.0f;
+    static constexpr int   NUM_TICKERS = 1;             // per-ticker state arrays (Ticker enum values 0..N-1)
+    static constexpr int   COALESCE_BOOK_UPDATES = 16;  // 0: requote on every book delta; N: once per burst, <= N deltas
+    static constexpr float QUEUE_HALF_QTY = 200.0f;     // contracts queued ahead that halve a quote's fill chance
+    static constexpr float REQUOTE_HURDLE = 0.25f;      // move a quote only for this much more expected edge
+    static constexpr bool  REACT_FAST = true;           // high-impact events cross off the reaction table first
 
     // Fair value model
     static constexpr float HOME_ADV_POINTS = 1.25f;
+    static constexpr float LOGIT_W_LEAD = 0.18f;        // per time-scaled point of lead
+    static constexpr float LOGIT_W_MOM = 0.10f;         // per late-weighted momentum point
+    static constexpr float LOGIT_W_HOME = 0.20f;        // per time-scaled home point
     static constexpr float MOM_EMA_ALPHA = 0.2f;
     static constexpr float BASE_EDGE_THRESH = 0.9f;     // price points
     static constexpr float LATE_TIGHTEN = 0.55f;        // threshold shrink factor late
+    static constexpr float FEATURE_WINDOW_SEC = 120.0f; // rolling feature window, game seconds
+    static constexpr float MODEL_REFIT_SEC = 0.0f;      // background refit period, wall seconds; 0 = off
 
     // Game/time
     static constexpr float GAME_LEN1 = 2400.0f;
     static constexpr float GAME_LEN2 = 2880.0f;
     static constexpr float INIT_COOLDOWN_SEC = 5.0f;    // after start
     static constexpr float CLOSE_OUT_BUFFER_SEC = 2.0f; // before END_GAME
+
+    // Diagnostics
+#ifdef KWOKKER_PROFILE
+    static constexpr bool  PROFILE_LATENCY = true;      // latency histograms, printed on END_GAME
+#else
+    static constexpr bool  PROFILE_LATENCY = false;
+#endif
+#ifdef KWOKKER_JOURNAL
+    static constexpr int   JOURNAL_RECORDS = KWOKKER_JOURNAL; // binary journal ring, 0 = off
+#else
+    static constexpr int   JOURNAL_RECORDS = 0;
+#endif
+#ifdef KWOKKER_CAPTURE
+    static constexpr int   CAPTURE_BYTES = KWOKKER_CAPTURE;   // session capture ring, 0 = off
+#else
+    static constexpr int   CAPTURE_BYTES = 0;
+#endif
   };
 
-  // ───────── State ─────────
+  // Same tunables as plain fields, for the research instantiation: sweeps can
+  // vary them without recompiling. Grid constants (PRICE_TICK, MAX_TICK,
+  // MIN_BOOK_QTY, NUM_TICKERS, GAME_LEN*, REACT_FAST, MODEL_REFIT_SEC,
+  // PROFILE_LATENCY, JOURNAL_RECORDS, CAPTURE_BYTES) stay static via Cfg.
+  struct RuntimeCfg : Cfg {
+    float MAX_POS              = Cfg::MAX_POS;
+    float RISK_PCT_PER_TRADE   = Cfg::RISK_PCT_PER_TRADE;
+    float POSITION_NUDGE_LATE  = Cfg::POSITION_NUDGE_LATE;
+    Tick  MAX_SPREAD_TO_CROSS  = Cfg::MAX_SPREAD_TO_CROSS;
+    Tick  PASSIVE_IMPROVE      = Cfg::PASSIVE_IMPROVE;
+    int   COALESCE_BOOK_UPDATES = Cfg::COALESCE_BOOK_UPDATES;
+    float QUEUE_HALF_QTY       = Cfg::QUEUE_HALF_QTY;
+    float REQUOTE_HURDLE       = Cfg::REQUOTE_HURDLE;
+    float HOME_ADV_POINTS      = Cfg::HOME_ADV_POINTS;
+    float LOGIT_W_LEAD         = Cfg::LOGIT_W_LEAD;
+    float LOGIT_W_MOM          = Cfg::LOGIT_W_MOM;
+    float LOGIT_W_HOME         = Cfg::LOGIT_W_HOME;
+    float MOM_EMA_ALPHA        = Cfg::MOM_EMA_ALPHA;
+    float BASE_EDGE_THRESH     = Cfg::BASE_EDGE_THRESH;
+    float LATE_TIGHTEN         = Cfg::LATE_TIGHTEN;
+    float FEATURE_WINDOW_SEC   = Cfg::FEATURE_WINDOW_SEC;
+    float INIT_COOLDOWN_SEC    = Cfg::INIT_COOLDOWN_SEC;
+    float CLOSE_OUT_BUFFER_SEC = Cfg::CLOSE_OUT_BUFFER_SEC;
+  };
+
+  // ───────── Game events ─────────
+  enum class EventType : std::uint8_t {
+    UNKNOWN, NOTHING, START_PERIOD, END_PERIOD, END_GAME, JUMP_BALL, SCORE, MISSED,
+    REBOUND, BLOCK, STEAL, TURNOVER, FOUL, TIMEOUT, SUBSTITUTION
+  };
+  enum class ShotType : std::uint8_t { NONE, FREE_THROW, TWO_POINT, THREE_POINT, LAYUP, DUNK };
+  enum class Team : std::uint8_t { UNKNOWN, HOME, AWAY };
+
+  // Classifiers switch on (length, one or two chars) and never compare whole
+  // strings. They assume the feed's fixed vocabulary; anything else maps to
+  // UNKNOWN/NONE only when its length or key chars differ.
+  static constexpr EventType classify_event(std::string_view s) {
+    if (s.empty()) return EventType::UNKNOWN;
+    switch (s.size()) {
+      case 4:  return s[0] == 'F' ? EventType::FOUL : EventType::UNKNOWN;
+      case 5:  return s[0] == 'B' ? EventType::BLOCK
+                    : s[1] == 'C' ? EventType::SCORE
+                    : s[1] == 'T' ? EventType::STEAL : EventType::UNKNOWN;
+      case 6:  return s[0] == 'M' ? EventType::MISSED : EventType::UNKNOWN;
+      case 7:  return s[0] == 'N' ? EventType::NOTHING
+                    : s[0] == 'R' ? EventType::REBOUND
+                    : s[0] == 'T' ? EventType::TIMEOUT : EventType::UNKNOWN;
+      case 8:  return s[0] == 'E' ? EventType::END_GAME
+                    : s[0] == 'T' ? EventType::TURNOVER : EventType::UNKNOWN;
+      case 9:  return s[0] == 'J' ? EventType::JUMP_BALL : EventType::UNKNOWN;
+      case 10: return s[0] == 'E' ? EventType::END_PERIOD : EventType::UNKNOWN;
+      case 12: return s[1] == 'T' ? EventType::START_PERIOD
+                    : s[1] == 'U' ? EventType::SUBSTITUTION : EventType::UNKNOWN;
+      default: return EventType::UNKNOWN;
+    }
+  }
+  static constexpr ShotType classify_shot(std::string_view s) {
+    switch (s.size()) {
+      case 4:  return s[0] == 'D' ? ShotType::DUNK : ShotType::NONE;
+      case 5:  return s[0] == 'L' ? ShotType::LAYUP : ShotType::NONE;
+      case 9:  return s[0] == 'T' ? ShotType::TWO_POINT : ShotType::NONE;
+      case 10: return s[0] == 'F' ? ShotType::FREE_THROW : ShotType::NONE;
+      case 11: return s[0] == 'T' ? ShotType::THREE_POINT : ShotType::NONE;
+      default: return ShotType::NONE;
+    }
+  }
+  static constexpr Team classify_team(std::string_view s) {
+    if (s.empty()) return Team::UNKNOWN;
+    return s[0] == 'h' ? Team::HOME : s[0] == 'a' ? Team::AWAY : Team::UNKNOWN;
+  }
+
+  // Pre-classified event; the string callback decodes into this, native
+  // drivers can build it directly.
+  struct GameEvent {
+    EventType type = EventType::UNKNOWN;
+    Team      team = Team::UNKNOWN;
+    ShotType  shot = ShotType::NONE;
+    int       home_score = 0, away_score = 0;
+    std::optional<double> coordinate_x, coordinate_y, time_seconds;
+  };
+
+  // Time-only model terms. They move only when t_rem_ does (game events),
+  // so the strategy computes them once per change and book-driven
+  // callbacks reuse them.
+  struct TimeFactors {
+    float t_rem    = 0.0f;   // the t_rem these were computed for, clamped at 0
+    float scale    = 1.0f;   // 1/sqrt(minutes remaining + 1): lead and home weight
+    float late     = 1.0f;   // 1..2 momentum weight, grows late
+    float late_fac = 1.0f;   // edge-threshold shrink, 1 - LATE_TIGHTEN * (late - 1)
+    float urgency  = 1.0f;   // 1..2 size multiplier, grows late
+
+    template <class C>
+    static TimeFactors at(const C &cfg, float t_rem) {
+      float t = std::max(t_rem, 0.0f);
+      float decay = 1.0f - std::tanh(t / 600.0f);
+      TimeFactors f;
+      f.t_rem    = t;
+      f.scale    = 1.0f / std::sqrt((t / 60.0f) + 1.0f);   // minutes-ish
+      f.late     = 1.0f + decay;
+      f.late_fac = 1.0f - cfg.LATE_TIGHTEN * decay;
+      f.urgency  = 1.0f + (1.0f - std::tanh(t / 800.0f));  // ~1→2
+      return f;
+    }
+  };
+
+  // ───────── Rolling features ─────────
+  // Game statistics over the last `window` seconds of game clock, for models
+  // richer than lead + momentum. Only events that move a statistic (scores,
+  // fouls, turnovers) enter a fixed ring; running sums are adjusted as they
+  // enter and expire, so each event costs O(1) amortized and nothing
+  // allocates. More than kCapacity such events inside one window expire the
+  // oldest early.
+  class RollingFeatures {
+  public:
+    static constexpr int kCapacity = 64;
+
+    void reset(float window_sec) { *this = RollingFeatures{}; window_ = window_sec; }
+
+    void on_event(const GameEvent &ev) {
+      if (ev.time_seconds) clock_ = float(*ev.time_seconds);
+      expire_();
+
+      // Points come from score deltas, so and-ones and corrections still add up.
+      int d[2] = {ev.home_score - score_[0], ev.away_score - score_[1]};
+      score_[0] = ev.home_score;
+      score_[1] = ev.away_score;
+      for (int side = 0; side < 2; ++side) {
+        if (d[side] <= 0) continue;
+        push_(POINTS, side, d[side], ev.shot);
+        if (run_side_ == side) run_pts_ += d[side];
+        else { run_side_ = side; run_pts_ = d[side]; }
+      }
+
+      int side = ev.team == Team::HOME ? 0 : ev.team == Team::AWAY ? 1 : -1;
+      if (side < 0) return;
+      if (ev.type == EventType::FOUL)     push_(FOUL, side, 1, ShotType::NONE);
+      if (ev.type == EventType::TURNOVER) push_(TURNOVER, side, 1, ShotType::NONE);
+    }
+
+    // Unanswered points of the current run: positive for home, negative for away.
+    int run() const { return run_side_ < 0 ? 0 : run_side_ == 0 ? run_pts_ : -run_pts_; }
+    // Windowed counts per team.
+    int points(Team t) const    { return t == Team::AWAY ? pts_[1] : pts_[0]; }
+    int fouls(Team t) const     { return t == Team::AWAY ? fouls_[1] : fouls_[0]; }
+    int turnovers(Team t) const { return t == Team::AWAY ? tov_[1] : tov_[0]; }
+    int made(Team t, ShotType s) const { return made_[t == Team::AWAY ? 1 : 0][std::size_t(s)]; }
+
+  private:
+    enum Kind : std::uint8_t { POINTS, FOUL, TURNOVER };
+    struct Entry {
+      float        clock;
+      std::uint8_t kind, side, value;
+      ShotType     shot;
+    };
+
+    void push_(Kind k, int side, int value, ShotType shot) {
+      if (size_ == kCapacity) pop_();
+      ring_[(head_ + size_++) % kCapacity] = Entry{clock_, k, std::uint8_t(side), std::uint8_t(value), shot};
+      apply_(ring_[(head_ + size_ - 1) % kCapacity], +1);
+    }
+    void pop_() {
+      apply_(ring_[head_], -1);
+      head_ = (head_ + 1) % kCapacity;
+      --size_;
+    }
+    // Game clock counts down: an entry expires once it is `window_` older.
+    void expire_() { while (size_ > 0 && ring_[head_].clock > clock_ + window_) pop_(); }
+
+    void apply_(const Entry &e, int sign) {
+      switch (e.kind) {
+        case POINTS:
+          pts_[e.side] += sign * e.value;
+          if (e.shot != ShotType::NONE) made_[e.side][std::size_t(e.shot)] += sign;
+          break;
+        case FOUL:     fouls_[e.side] += sign; break;
+        case TURNOVER: tov_[e.side] += sign; break;
+      }
+    }
+
+    Entry ring_[kCapacity] = {};
+    int   head_ = 0, size_ = 0;
+    float window_ = Cfg::FEATURE_WINDOW_SEC;
+    float clock_ = Cfg::GAME_LEN2;
+    int   score_[2] = {0, 0};
+    int   run_side_ = -1, run_pts_ = 0;
+    int   pts_[2] = {0, 0}, fouls_[2] = {0, 0}, tov_[2] = {0, 0};
+    int   made_[2][6] = {};   // by ShotType
+  };
+
+  // ───────── Reaction table ─────────
+  // Fair-value jump, in ticks, that an event of each class causes, keyed by
+  // (class, time-remaining bucket, lead before the event). Filled once from
+  // the fair-value policy at construction (see BasicStrategy::build_reactions_)
+  // so a high-impact event can be priced with one load: last fair + jump.
+  // Whole ticks are fine-grained enough for this first look, which only
+  // decides whether to send a cross before the model runs.
+  // Jumps are taken with zero prior momentum and otherwise empty rolling
+  // features, so they are the event's own effect; the full model still runs
+  // right after. Time buckets narrow toward the end, where prices move most.
+  // Only scores have classes: turnovers and fouls are high impact only in
+  // the last minute, which the fast path leaves to try_trade_ (see react_),
+  // and bucket 0 (under a minute) is never read for the same reason.
+  class ReactionTable {
+  public:
+    enum Class : std::uint8_t {
+      HOME_1, HOME_2, HOME_3, AWAY_1, AWAY_2, AWAY_3,   // points scored
+      kClasses
+    };
+    static constexpr float kTimeEdges[] = {60, 90, 120, 180, 300, 480, 720, 1200, 1800, 2400};
+    static constexpr int   kTimeBuckets = int(std::size(kTimeEdges)) + 1;
+    static constexpr int   kMaxLead = 20;   // |lead| beyond this shares the edge bucket
+    static constexpr int   kLeads = 2 * kMaxLead + 1;
+
+    // Class of an event given the lead change it caused; -1 if it has none.
+    static int class_of(const GameEvent &ev, int dlead) {
+      if (ev.type != EventType::SCORE || dlead == 0 || dlead < -3 || dlead > 3) return -1;
+      return dlead > 0 ? HOME_1 + dlead - 1 : AWAY_1 - dlead - 1;
+    }
+    static int time_bucket(float t_rem) {
+      int b = 0;
+      while (b < kTimeBuckets - 1 && t_rem >= kTimeEdges[b]) ++b;
+      return b;
+    }
+    // Middle of a time bucket, where its entries are evaluated.
+    static float time_mid(int b) {
+      float lo = b == 0 ? 0.0f : kTimeEdges[b - 1];
+      float hi = b == kTimeBuckets - 1 ? Cfg::GAME_LEN2 : kTimeEdges[b];
+      return 0.5f * (lo + hi);
+    }
+    static int lead_bucket(float lead) { return std::clamp(int(std::lround(lead)), -kMaxLead, kMaxLead) + kMaxLead; }
+
+    int  jump(int cls, float t_rem, float lead) const { return jump_[cls][time_bucket(t_rem)][lead_bucket(lead)]; }
+    void set(int cls, int tb, int lb, int ticks) { jump_[cls][tb][lb] = std::int16_t(ticks); }
+
+  private:
+    std::int16_t jump_[kClasses][kTimeBuckets][kLeads] = {};
+  };
+
+  // ───────── Tree ensembles ─────────
+  // Inputs a tree model can read, by name in the exported model (see
+  // sim/xgb2cpp.cpp). MISSING is always NaN and takes the default branch.
+  enum class Feature : std::uint8_t {
+    MISSING, LEAD, MOMENTUM, T_REM, HOME_ADV,
+    // RollingFeatures, over the window
+    RUN, HOME_PTS, AWAY_PTS, HOME_FOULS, AWAY_FOULS, HOME_TOV, AWAY_TOV, HOME_3PM, AWAY_3PM
+  };
+
+  // One node of a flattened tree. Children are adjacent: left at `left`,
+  // right at `left + 1`. Leaves carry their output in `value`.
+  struct TreeNode {
+    float         value;          // split threshold (go left if x < value) or leaf output
+    std::uint16_t feature;        // index into the model's input vector
+    std::uint8_t  default_left;   // branch taken when the input is NaN
+    std::uint8_t  leaf;
+    std::uint32_t left;
+  };
+
+  // Sum of leaf outputs over n trees. Four trees walk in lockstep so their
+  // dependent loads overlap; each step is a select, not a branch.
+  static float forest_sum(const TreeNode *nodes, const std::uint32_t *roots, std::size_t n, const float *x) {
+    auto step = [&](std::uint32_t i) {
+      const TreeNode &nd = nodes[i];
+      float v = x[nd.feature];
+      bool go_left = v < nd.value || (v != v && nd.default_left);
+      return nd.leaf ? i : nd.left + std::uint32_t(!go_left);
+    };
+    float sum = 0.0f;
+    std::size_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+      std::uint32_t a = roots[k], b = roots[k + 1], c = roots[k + 2], d = roots[k + 3];
+      while (!(nodes[a].leaf & nodes[b].leaf & nodes[c].leaf & nodes[d].leaf)) {
+        a = step(a); b = step(b); c = step(c); d = step(d);
+      }
+      sum += (nodes[a].value + nodes[b].value) + (nodes[c].value + nodes[d].value);
+    }
+    for (; k < n; ++k) {
+      std::uint32_t a = roots[k];
+      while (!nodes[a].leaf) a = step(a);
+      sum += nodes[a].value;
+    }
+    return sum;
+  }
+
+  // ───────── Book ─────────
+  // Flat price ladder: one slot per PRICE_TICK over [0, 100], indexed by
+  // integer tick. Fixed size, so updates never touch the heap. Top of book
+  // (levels with qty >= MIN_BOOK_QTY) is maintained on every update.
+  //
+  // Snapshots are applied as a diff: begin_snapshot(), snap_bid/snap_ask per
+  // level, end_snapshot(). Levels whose quantity is unchanged are not
+  // written, levels the snapshot leaves out are found by an epoch stamp
+  // within each side's occupied range and zeroed, and top of book is
+  // recomputed only if a best level moved. Levels below MIN_BOOK_QTY in a
+  // snapshot count as absent.
   struct OB {
-    std::map<float, float, std::greater<float>> bids; // price->qty
-    std::map<float, float, std::less<float>>    asks; // price->qty
-    void clear() { bids.clear(); asks.clear(); }
-  } book_;
+    static constexpr int LEVELS = Cfg::MAX_TICK + 1;  // 1001
+
+    struct Top {
+      bool  ok = false;        // both sides present
+      Tick  bid = 0, ask = 0, spread = 0;
+      float mid = 0.0f;        // price points
+    };
+
+    float bids[LEVELS] = {};   // tick->qty, 0 = empty
+    float asks[LEVELS] = {};   // tick->qty, 0 = empty
+    Tick  bid_top = -1;        // best bid tick with qty >= MIN_BOOK_QTY (-1 if none)
+    Tick  ask_top = LEVELS;    // best ask tick with qty >= MIN_BOOK_QTY (LEVELS if none)
+    Top   top_;
+
+    const Top& top() const { return top_; }
+
+    void set_bid(Tick t, float qty) {
+      track_(bids[t], qty, bid_lo_, bid_hi_, bid_levels_, t);
+      bids[t] = std::max(qty, 0.0f);
+      if (qty >= Cfg::MIN_BOOK_QTY) {
+        if (t <= bid_top) return;
+        bid_top = t;
+      } else {
+        if (t != bid_top) return;
+        while (bid_top >= 0 && bids[bid_top] < Cfg::MIN_BOOK_QTY) --bid_top;
+      }
+      refresh_top_();
+    }
+    void set_ask(Tick t, float qty) {
+      track_(asks[t], qty, ask_lo_, ask_hi_, ask_levels_, t);
+      asks[t] = std::max(qty, 0.0f);
+      if (qty >= Cfg::MIN_BOOK_QTY) {
+        if (t >= ask_top) return;
+        ask_top = t;
+      } else {
+        if (t != ask_top) return;
+        while (ask_top < LEVELS && asks[ask_top] < Cfg::MIN_BOOK_QTY) ++ask_top;
+      }
+      refresh_top_();
+    }
+
+    void clear() {
+      std::fill(std::begin(bids), std::end(bids), 0.0f);
+      std::fill(std::begin(asks), std::end(asks), 0.0f);
+      bid_top = -1;
+      ask_top = LEVELS;
+      top_ = Top{};
+      bid_lo_ = ask_lo_ = LEVELS;
+      bid_hi_ = ask_hi_ = -1;
+      bid_levels_ = ask_levels_ = 0;
+    }
+
+    void begin_snapshot() {
+      if (++epoch_ == 0) {   // wrapped: old stamps could alias the new epoch
+        std::fill(std::begin(bid_seen_), std::end(bid_seen_), std::uint16_t(0));
+        std::fill(std::begin(ask_seen_), std::end(ask_seen_), std::uint16_t(0));
+        epoch_ = 1;
+      }
+      snap_bid_top_ = -1;
+      snap_ask_top_ = LEVELS;
+      snap_bids_ = snap_asks_ = 0;
+    }
+    void snap_bid(Tick t, float qty) {
+      if (qty < Cfg::MIN_BOOK_QTY) return;
+      if (bid_seen_[t] != epoch_) { bid_seen_[t] = epoch_; ++snap_bids_; }
+      if (bids[t] != qty) { track_(bids[t], qty, bid_lo_, bid_hi_, bid_levels_, t); bids[t] = qty; }
+      snap_bid_top_ = std::max(snap_bid_top_, t);
+    }
+    void snap_ask(Tick t, float qty) {
+      if (qty < Cfg::MIN_BOOK_QTY) return;
+      if (ask_seen_[t] != epoch_) { ask_seen_[t] = epoch_; ++snap_asks_; }
+      if (asks[t] != qty) { track_(asks[t], qty, ask_lo_, ask_hi_, ask_levels_, t); asks[t] = qty; }
+      snap_ask_top_ = std::min(snap_ask_top_, t);
+    }
+    // Returns true if top of book moved.
+    bool end_snapshot() {
+      // Every occupied level stamped means none was left out: skip the sweep.
+      if (bid_levels_ != snap_bids_) sweep_(bids, bid_seen_, bid_lo_, bid_hi_, bid_levels_);
+      if (ask_levels_ != snap_asks_) sweep_(asks, ask_seen_, ask_lo_, ask_hi_, ask_levels_);
+      Tick b = snap_bid_top_, a = snap_ask_top_;   // every stamped level is >= MIN_BOOK_QTY
+      if (b == bid_top && a == ask_top) return false;
+      bid_top = b;
+      ask_top = a;
+      top_ = Top{};
+      refresh_top_();
+      return true;
+    }
+
+  private:
+    // Occupied range and count of nonzero levels, ahead of a level changing from `was` to `qty`.
+    static void track_(float was, float qty, Tick &lo, Tick &hi, int &levels, Tick t) {
+      if (qty > 0.0f) {
+        lo = std::min(lo, t);
+        hi = std::max(hi, t);
+      }
+      levels += int(qty > 0.0f) - int(was > 0.0f);
+    }
+    // Zero levels in [lo, hi] the current snapshot did not stamp, then
+    // shrink the range to what is left.
+    void sweep_(float *side, const std::uint16_t *seen, Tick &lo, Tick &hi, int &levels) {
+      Tick new_lo = LEVELS, new_hi = -1;
+      for (Tick t = lo; t <= hi; ++t) {
+        if (side[t] == 0.0f) continue;
+        if (seen[t] != epoch_) { side[t] = 0.0f; --levels; continue; }
+        new_lo = std::min(new_lo, t);
+        new_hi = t;
+      }
+      lo = new_lo;
+      hi = new_hi;
+    }
+
+    void refresh_top_() {
+      top_.ok = bid_top >= 0 && ask_top < LEVELS;
+      if (!top_.ok) return;
+      top_.bid    = bid_top;
+      top_.ask    = ask_top;
+      top_.spread = Tick(std::max(0, ask_top - bid_top));
+      top_.mid    = float(bid_top + ask_top) * (0.5f * Cfg::PRICE_TICK);
+    }
+
+    // Ticks that may hold a nonzero quantity, and how many do, per side
+    Tick bid_lo_ = LEVELS, bid_hi_ = -1, ask_lo_ = LEVELS, ask_hi_ = -1;
+    int  bid_levels_ = 0, ask_levels_ = 0;
+    // Snapshot diffing state
+    std::uint16_t bid_seen_[LEVELS] = {};
+    std::uint16_t ask_seen_[LEVELS] = {};
+    std::uint16_t epoch_ = 0;
+    Tick          snap_bid_top_ = -1, snap_ask_top_ = LEVELS;
+    int           snap_bids_ = 0, snap_asks_ = 0;   // distinct levels stamped this snapshot
+  };
+
+  // ───────── Accounting ─────────
+  // One ticker's position and PnL, kept up to date per fill and per order
+  // action in constant time. The average entry is the volume-weighted price
+  // of the open position: a fill that reduces the position realizes
+  // (price - entry) per closed contract, and one through zero opens the rest
+  // at its own price. Unrealized PnL is marked wherever the caller asks.
+  //
+  // Resting exposure is what our passive orders could still add on each
+  // side, held when one is placed and released as it fills or is cancelled.
+  // IOC and market orders are not held: fills on them arrive as account
+  // updates straight after the call. Money is kept in double, since a game's
+  // cash flows run to 1e5 while one fill moves them by a tick.
+  class Account {
+  public:
+    void fill(float qty, float price) {   // qty signed: + bought, - sold (per engine)
+      double q = qty, pos = position_, p = price;
+      if (pos == 0.0 || (pos > 0.0) == (q > 0.0)) {
+        entry_ = (entry_ * std::fabs(pos) + p * std::fabs(q)) / (std::fabs(pos) + std::fabs(q));
+      } else {
+        realized_ += std::min(std::fabs(q), std::fabs(pos)) * (p - entry_) * (pos > 0.0 ? 1.0 : -1.0);
+        if (std::fabs(q) > std::fabs(pos)) entry_ = p;
+      }
+      position_ += qty;
+      if (position_ == 0.0f) entry_ = 0.0;
+    }
+
+    void hold(Side s, float qty)    { open_[s == Side::sell] += qty; }
+    void release(Side s, float qty) { open_[s == Side::sell] = std::max(0.0f, open_[s == Side::sell] - qty); }
+
+    float  position() const { return position_; }
+    double entry() const { return entry_; }
+    double realized() const { return realized_; }
+    double unrealized(float mark) const { return double(position_) * (double(mark) - entry_); }
+    double pnl(float mark) const { return realized_ + unrealized(mark); }
+    float  open(Side s) const { return open_[s == Side::sell]; }
+
+    // Contracts a new `s` order may add before the position, with resting
+    // orders on that side counted as filled, reaches `limit` either way.
+    // `replacing` is resting quantity the order replaces.
+    float room(Side s, float limit, float replacing = 0.0f) const {
+      float held = open(s) - replacing;
+      return s == Side::buy ? limit - position_ - held : limit + position_ - held;
+    }
+
+    // Flat with nothing held; resting orders are cancelled separately.
+    void reset() { *this = Account{}; }
+
+  private:
+    float  position_ = 0.0f;
+    double entry_ = 0.0, realized_ = 0.0;
+    float  open_[2] = {};   // resting buy, sell quantity
+  };
+
+  // ───────── Latency profile ─────────
+  // Opt-in timings (Cfg::PROFILE_LATENCY, or -DKWOKKER_PROFILE) of each
+  // callback and of each decision branch, in log-linear histograms: 16
+  // sub-buckets per power of two of nanoseconds, so any percentile is within
+  // about 6% and recording is a shift and an increment. Fixed size, and
+  // report() formats into a buffer reserved at construction, so nothing
+  // allocates. With profiling off the strategy holds a NoProfile instead and
+  // every probe compiles away.
+  enum class Probe : std::uint8_t {
+    TRADE, BOOK, SNAPSHOT, ACCOUNT, GAME,   // callbacks
+    DECIDE,                                 // try_trade_, whole
+    CROSS, PASSIVE, NUDGE, FLATTEN,         // decision branches
+    REACT,                                  // high-impact fast path, see react_()
+    COUNT
+  };
+  static constexpr const char *kProbeNames[] = {"trade", "book", "snapshot", "account", "game",
+                                                "decide", "cross", "passive", "nudge", "flatten", "react"};
+
+  class LatencyHistogram {
+  public:
+    static constexpr int kSubBits = 4;
+    static constexpr int kSub = 1 << kSubBits;
+    static constexpr int kMaxBit = 36;                        // ~68 s; longer is clamped
+    static constexpr int kBuckets = (kMaxBit - kSubBits + 1) * kSub;
+
+    void record(std::uint64_t ns) {
+      ++counts_[bucket_(ns)];
+      ++n_;
+      max_ = std::max(max_, ns);
+    }
+    std::uint64_t count() const { return n_; }
+    std::uint64_t max() const { return max_; }
+    // Upper bound of the bucket holding the q-quantile (q in [0, 1]).
+    std::uint64_t percentile(double q) const {
+      std::uint64_t rank = std::uint64_t(q * double(n_)), seen = 0;
+      for (int b = 0; b < kBuckets; ++b)
+        if ((seen += counts_[b]) > rank) return std::min(upper_(b), max_);
+      return max_;
+    }
+    void clear() { *this = LatencyHistogram{}; }
+
+  private:
+    static int bucket_(std::uint64_t v) {
+      if (v < std::uint64_t(2 * kSub)) return int(v);
+      int msb = 63;
+      while (!(v >> msb)) --msb;
+      if (msb > kMaxBit) return kBuckets - 1;
+      int shift = msb - kSubBits;
+      return (shift + 1) * kSub + int(v >> shift) - kSub;
+    }
+    static std::uint64_t upper_(int b) {
+      if (b < 2 * kSub) return std::uint64_t(b);
+      int shift = b / kSub - 1;
+      return ((std::uint64_t(kSub + b % kSub) + 1) << shift) - 1;
+    }
+
+    std::uint32_t counts_[kBuckets] = {};
+    std::uint64_t n_ = 0, max_ = 0;
+  };
+
+  class LatencyProfile {
+  public:
+    // Records the time from construction to destruction under one probe.
+    class Scope {
+    public:
+      Scope(LatencyProfile &p, Probe probe) : p_(p), probe_(probe), t0_(now_ns_()) {}
+      ~Scope() { p_.hist_[std::size_t(probe_)].record(now_ns_() - t0_); }
+      Scope(const Scope &) = delete;
+      Scope &operator=(const Scope &) = delete;
+
+    private:
+      LatencyProfile &p_;
+      Probe           probe_;
+      std::uint64_t   t0_;
+    };
+
+    LatencyProfile() { text_.reserve((std::size_t(Probe::COUNT) + 2) * 80); }
+
+    Scope scope(Probe p) { return Scope(*this, p); }
+    const LatencyHistogram &histogram(Probe p) const { return hist_[std::size_t(p)]; }
+
+    // One line per probe that fired: count, p50/p90/p99/p99.9 and max in ns.
+    const std::string &report(const char *title) {
+      std::string &out = text_;
+      out = title;
+      char line[160];
+      std::snprintf(line, sizeof line, "\n%-9s %10s %8s %8s %8s %8s %10s", "probe", "n", "p50", "p90", "p99", "p99.9", "max");
+      out += line;
+      for (std::size_t i = 0; i < std::size_t(Probe::COUNT); ++i) {
+        const LatencyHistogram &h = hist_[i];
+        if (h.count() == 0) continue;
+        std::snprintf(line, sizeof line, "\n%-9s %10llu %8llu %8llu %8llu %8llu %10llu", kProbeNames[i],
+                      (unsigned long long)h.count(), (unsigned long long)h.percentile(0.50),
+                      (unsigned long long)h.percentile(0.90), (unsigned long long)h.percentile(0.99),
+                      (unsigned long long)h.percentile(0.999), (unsigned long long)h.max());
+        out += line;
+      }
+      return out;
+    }
+    void clear() { for (LatencyHistogram &h : hist_) h.clear(); }
+
+  private:
+    static std::uint64_t now_ns_() {
+      using namespace std::chrono;
+      return std::uint64_t(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+    }
+
+    LatencyHistogram hist_[std::size_t(Probe::COUNT)];
+    std::string      text_;
+  };
+
+  // Stand-in when profiling is off: same calls, no state, no clock reads.
+  struct NoProfile {
+    struct Scope { ~Scope() {} };   // non-trivial, so unused scopes do not warn
+    Scope scope(Probe) { return {}; }
+    void clear() {}
+  };
+
+  // ───────── Journal ─────────
+  // Fixed-size binary log records in a preallocated single-producer ring:
+  // the strategy writes them from its callbacks without allocating or
+  // formatting, and drain() turns whatever has accumulated into compact text
+  // for one println. Head and tail are atomics (release on publish, acquire
+  // on read), so a native driver may also drain from another thread; a full
+  // ring drops the newest record and counts it.
+  struct JournalRecord {
+    double       wall;         // strategy clock, seconds
+    float        t_rem;        // game clock
+    float        price, qty;   // callback or order arguments (GAME: home, away score)
+    float        position;     // when recorded; order fills land in later ACCOUNT records
+    float        fair;         // cached fair price at the time
+    float        edge;         // decision edge in price points, 0 for callbacks
+    Probe        kind;         // callback or decision branch
+    std::uint8_t side;         // 0 buy, 1 sell
+    std::uint8_t ticker;
+  };
+
+  class Journal {
+  public:
+    // Characters per formatted record, for sizing the text buffer.
+    static constexpr std::size_t kLineChars = 80;
+
+    explicit Journal(std::size_t capacity)
+        : ring_(capacity), high_water_(capacity - capacity / 4) {
+      text_.reserve((capacity + 2) * kLineChars);
+    }
+
+    // False if the ring was full and the record was dropped.
+    bool push(const JournalRecord &r) {
+      std::size_t h = head_.load(std::memory_order_relaxed);
+      if (h - tail_.load(std::memory_order_acquire) >= ring_.size()) { ++dropped_; return false; }
+      ring_[h % ring_.size()] = r;
+      head_.store(h + 1, std::memory_order_release);
+      return true;
+    }
+    std::size_t size() const {
+      return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+    }
+    bool above_high_water() const { return size() >= high_water_; }
+
+    // Consumes every published record into a reused text buffer: a header
+    // line, then one line per record. Stays within the reserved capacity,
+    // so draining does not allocate either.
+    const std::string &drain(const char *title) {
+      text_.clear();
+      char line[2 * kLineChars];
+      std::size_t t = tail_.load(std::memory_order_relaxed), h = head_.load(std::memory_order_acquire);
+      std::snprintf(line, sizeof line, "%s %zu records, %zu dropped\n%-12s %7s %-8s %s %2s %7s %7s %8s %6s %6s",
+                    title, h - t, dropped_, "wall", "t_rem", "kind", "s", "tk", "price", "qty", "pos", "fair", "edge");
+      text_ += line;
+      for (; t != h; ++t) {
+        const JournalRecord &r = ring_[t % ring_.size()];
+        std::snprintf(line, sizeof line, "\n%12.6f %7.1f %-8s %c %2u %7.2f %7.0f %8.0f %6.1f %6.1f", r.wall, double(r.t_rem),
+                      kProbeNames[std::size_t(r.kind)], r.side ? 's' : 'b', unsigned(r.ticker), double(r.price),
+                      double(r.qty), double(r.position), double(r.fair), double(r.edge));
+        text_ += line;
+      }
+      tail_.store(h, std::memory_order_release);
+      dropped_ = 0;
+      return text_;
+    }
+
+  private:
+    std::vector<JournalRecord> ring_;
+    std::size_t                high_water_;
+    std::atomic<std::size_t>   head_{0}, tail_{0};
+    std::size_t                dropped_ = 0;
+    std::string                text_;
+  };
+
+  // Stand-in when journaling is off.
+  struct NoJournal {
+    explicit NoJournal(std::size_t) {}
+  };
+
+  // ───────── Model refit ─────────
+  // Opt-in (Cfg::MODEL_REFIT_SEC > 0) mid-game recalibration off the
+  // callback thread. Callbacks post one Observation per model refresh into a
+  // fixed single-producer ring; a worker thread wakes every MODEL_REFIT_SEC,
+  // folds them into a ridge fit of the momentum weight and home advantage
+  // against the market's implied probability (shrunk toward the configured
+  // values), and publishes the result through a triple buffer. Both hand-offs
+  // are wait-free, so callbacks never block or allocate. Worker timing makes
+  // runs with refit on non-reproducible.
+
+  // The fair-value parameters a refit may move, named as in Cfg so the
+  // policies read them the same way (LogisticFairValue uses all four,
+  // TreeFairValue only HOME_ADV_POINTS). `gen` tags the game they belong to.
+  struct LogitParams {
+    float HOME_ADV_POINTS, LOGIT_W_LEAD, LOGIT_W_MOM, LOGIT_W_HOME;
+    std::uint32_t gen = 0;
+
+    template <class C>
+    static LogitParams from(const C &cfg) {
+      return {cfg.HOME_ADV_POINTS, cfg.LOGIT_W_LEAD, cfg.LOGIT_W_MOM, cfg.LOGIT_W_HOME};
+    }
+  };
+
+  // Single-writer, single-reader latest-value hand-off. Three slots: the
+  // writer fills its back slot and swaps it into the middle; the reader swaps
+  // its front slot for the middle when that holds something newer. Each side
+  // is one atomic exchange, and neither ever sees a half-written value.
+  template <class T>
+  class TripleBuffer {
+  public:
+    T &back() { return slots_[back_]; }
+    void publish() { back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & kIndex; }
+
+    // True if a newer value was taken; front() stays put until the next take.
+    bool take() {
+      if (!(middle_.load(std::memory_order_relaxed) & kFresh)) return false;
+      front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndex;
+      return true;
+    }
+    const T &front() const { return slots_[front_]; }
+
+  private:
+    static constexpr unsigned kIndex = 3, kFresh = 4;
+    T slots_[3] = {};
+    alignas(64) std::atomic<unsigned> middle_{1};
+    alignas(64) unsigned front_ = 0;   // reader's
+    alignas(64) unsigned back_ = 2;    // writer's
+  };
+
+  // Model inputs at one refresh, with the market's price as the label.
+  struct Observation {
+    float x_lead;   // lead * scale
+    float x_mom;    // late * momentum
+    float scale;    // time scale, multiplies the home terms
+    float mid;      // market mid, price points
+    std::uint32_t gen;
+  };
+
+  class ModelRefitter {
+  public:
+    static constexpr std::size_t kRing = 256;   // observations between wake-ups; more are dropped
+    static constexpr int   kMinObs = 8;          // publish once the decayed count n reaches this (9 obs)
+    static constexpr float kForget = 0.98f;      // per-observation decay of older ones
+    static constexpr float kRidge  = 4.0f;       // pull toward the configured parameters
 
-  float capital_remaining_ = 100000.0f;
-  float position_ = 0.0f;
+    ModelRefitter(const LogitParams &prior, float period_sec)
+        : prior_(prior), period_(period_sec), worker_([this] { run_(); }) {}
+    ~ModelRefitter() {
+      { std::lock_guard<std::mutex> lock(mu_); stop_ = true; }
+      wake_.notify_one();
+      worker_.join();
+    }
+    ModelRefitter(const ModelRefitter &) = delete;
+    ModelRefitter &operator=(const ModelRefitter &) = delete;
+
+    // Callback thread. Starts a new game's fit; returns its generation.
+    std::uint32_t restart() {
+      gen_.store(++cur_gen_, std::memory_order_release);
+      return cur_gen_;
+    }
+    // Callback thread. False if the ring was full.
+    bool observe(const Observation &o) {
+      std::size_t h = head_.load(std::memory_order_relaxed);
+      if (h - tail_.load(std::memory_order_acquire) >= kRing) return false;
+      ring_[h % kRing] = o;
+      head_.store(h + 1, std::memory_order_release);
+      return true;
+    }
+    // Callback thread. Newest published parameters, if any since the last
+    // call; sets from an earlier game are skipped.
+    bool poll(LogitParams &out) {
+      if (!fits_.take() || fits_.front().gen != cur_gen_) return false;
+      out = fits_.front();
+      return true;
+    }
+
+  private:
+    void run_() {
+      std::uint32_t gen = 0;
+      float a11 = 0, a12 = 0, a22 = 0, b1 = 0, b2 = 0, n = 0;
+      std::unique_lock<std::mutex> lock(mu_);
+      while (!wake_.wait_for(lock, std::chrono::duration<float>(period_), [this] { return stop_; })) {
+        std::uint32_t g = gen_.load(std::memory_order_acquire);
+        if (g != gen) { gen = g; a11 = a12 = a22 = b1 = b2 = n = 0.0f; }
+
+        // Residual logit after the lead term, regressed on (momentum, home).
+        std::size_t t = tail_.load(std::memory_order_relaxed), h = head_.load(std::memory_order_acquire);
+        for (; t != h; ++t) {
+          const Observation &o = ring_[t % kRing];
+          if (o.gen != gen) continue;
+          float p = std::clamp(o.mid / 100.0f, 0.02f, 0.98f);
+          float r = std::log(p / (1.0f - p)) - prior_.LOGIT_W_LEAD * o.x_lead;
+          float u1 = o.x_mom, u2 = prior_.LOGIT_W_HOME * o.scale;
+          a11 = kForget * a11 + u1 * u1; a12 = kForget * a12 + u1 * u2; a22 = kForget * a22 + u2 * u2;
+          b1  = kForget * b1 + u1 * r;   b2  = kForget * b2 + u2 * r;   n   = kForget * n + 1.0f;
+        }
+        tail_.store(h, std::memory_order_release);
+        if (n < float(kMinObs)) continue;
+
+        // (A + kRidge I) w = b + kRidge w0, a 2x2 solve
+        float m11 = a11 + kRidge, m22 = a22 + kRidge, det = m11 * m22 - a12 * a12;
+        float c1 = b1 + kRidge * prior_.LOGIT_W_MOM, c2 = b2 + kRidge * prior_.HOME_ADV_POINTS;
+        if (!(std::fabs(det) > 1e-6f)) continue;
+        LogitParams &out = fits_.back();
+        out = prior_;
+        out.LOGIT_W_MOM     = (c1 * m22 - a12 * c2) / det;
+        out.HOME_ADV_POINTS = (m11 * c2 - a12 * c1) / det;
+        out.gen = gen;
+        fits_.publish();
+      }
+    }
+
+    const LogitParams prior_;
+    const float       period_;
+    Observation       ring_[kRing] = {};
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::atomic<std::uint32_t> gen_{0};
+    std::uint32_t     cur_gen_ = 0;   // callback thread's copy of gen_
+    TripleBuffer<LogitParams> fits_;
+    std::mutex              mu_;      // worker sleep and stop only
+    std::condition_variable wake_;
+    bool                    stop_ = false;
+    std::thread             worker_;  // last: starts once the rest is built
+  };
+
+  // Stand-in when refit is off.
+  struct NoRefitter {
+    NoRefitter(const LogitParams &, float) {}
+    std::uint32_t restart() { return 0; }
+    bool observe(const Observation &) { return false; }
+    bool poll(LogitParams &) { return false; }
+  };
+
+  // ───────── Session capture ─────────
+  // Opt-in (Cfg::CAPTURE_BYTES, or -DKWOKKER_CAPTURE=bytes) recording of a
+  // whole session: every inbound callback with its arguments and the
+  // strategy clock, and every outbound order call with its result, in the
+  // order they happened. Records are packed into a preallocated
+  // single-producer byte ring (atomic head/tail, as in Journal) and leave
+  // through println as base64 lines, "capture <seq> <data>", when the ring
+  // is three-quarters full and at END_GAME. sim/capture.hpp decodes such a
+  // log and re-drives a fresh Strategy with it, checking every order call.
+  //
+  // Record: u32 size, u8 CaptureTag, u8 ticker, u16 0, f64 clock, then the
+  // tag's fields in call order, native byte order. Outbound records are
+  // written when the call returns, so callbacks the engine delivers inside
+  // an order call come before it.
+  enum class CaptureTag : std::uint8_t {
+    START,                                   // clock at construction
+    TRADE, BOOK, SNAPSHOT, ACCOUNT, GAME,    // inbound
+    MARKET, LIMIT, CANCEL,                   // outbound, with results
+    COUNT
+  };
+
+  class Capture {
+  public:
+    static constexpr std::size_t kHeader = 16;
+    static constexpr std::size_t kChunk = 3 * 1024;   // raw bytes per println line
 
-  // Game state
-  float t_rem_ = Cfg::GAME_LEN2;
-  int   home_ = 0, away_ = 0;
-  float lead_ = 0.0f;
-  float momentum_ = 0.0f;    // EMA of lead delta
-  bool  seen_event_ = false;
+    explicit Capture(std::size_t capacity)
+        : ring_(capacity), high_water_(capacity - capacity / 4) {
+      text_.reserve(24 + (kChunk + 2) / 3 * 4);
+    }
+
+    // One fixed-size record; false (and counted) if it does not fit.
+    template <class... F>
+    bool put(CaptureTag tag, std::size_t ticker, double clock, const F &...fields) {
+      constexpr std::size_t n = kHeader + (sizeof(F) + ... + 0);
+      if (!begin_(n)) return false;
+      std::uint8_t rec[n];   // packed on the stack, then one copy into the ring
+      std::uint8_t *o = header_(rec, n, tag, ticker, clock);
+      ((std::memcpy(o, &fields, sizeof(F)), o += sizeof(F)), ...);
+      write_(rec, n);
+      commit_();
+      return true;
+    }
+    // Book snapshot: both level counts, then (price, qty) pairs per side.
+    template <class Levels>
+    bool put_snapshot(std::size_t ticker, double clock, const Levels &bids, const Levels &asks) {
+      std::uint32_t nb = std::uint32_t(bids.size()), na = std::uint32_t(asks.size());
+      std::size_t n = kHeader + 2 * sizeof(std::uint32_t) + (std::size_t(nb) + na) * 2 * sizeof(float);
+      if (!begin_(n)) return false;
+      std::uint8_t rec[kHeader];
+      header_(rec, n, CaptureTag::SNAPSHOT, ticker, clock);
+      write_(rec, kHeader);
+      write_(&nb, sizeof nb);
+      write_(&na, sizeof na);
+      for (const Levels *side : {&bids, &asks})
+        for (const auto &pq : *side) { write_(&pq.first, sizeof(float)); write_(&pq.second, sizeof(float)); }
+      commit_();
+      return true;
+    }
+
+    std::size_t size() const { return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed); }
+    bool above_high_water() const { return size() >= high_water_; }
+    std::size_t dropped() const { return dropped_; }
+
+    // Hands every published byte to emit(text) as "capture <seq> <base64>"
+    // lines of at most kChunk raw bytes. A dropped record (bigger than the
+    // ring) is reported as "capture <seq> dropped <n>" so a reader knows the
+    // session has a gap. Reuses one reserved buffer, so it does not allocate.
+    template <class Emit>
+    void drain(Emit &&emit) {
+      static constexpr char kB64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+      char head[48];
+      if (dropped_) {
+        std::snprintf(head, sizeof head, "capture %llu dropped %zu", (unsigned long long)seq_++, dropped_);
+        text_ = head;
+        emit(text_);
+        dropped_ = 0;
+      }
+      std::size_t t = tail_.load(std::memory_order_relaxed), h = head_.load(std::memory_order_acquire);
+      std::size_t at = t % ring_.size();
+      auto next = [&] {
+        std::uint32_t b = ring_[at];
+        if (++at == ring_.size()) at = 0;
+        return b;
+      };
+      while (t != h) {
+        std::size_t n = std::min(kChunk, h - t);
+        int prefix = std::snprintf(head, sizeof head, "capture %llu ", (unsigned long long)seq_++);
+        text_.assign(head, std::size_t(prefix));
+        text_.resize(std::size_t(prefix) + (n + 2) / 3 * 4);
+        char *o = &text_[std::size_t(prefix)];
+        for (std::size_t i = 0; i < n; i += 3, o += 4) {
+          std::uint32_t v = next() << 16;
+          if (i + 1 < n) v |= next() << 8;
+          if (i + 2 < n) v |= next();
+          o[0] = kB64[(v >> 18) & 63];
+          o[1] = kB64[(v >> 12) & 63];
+          o[2] = i + 1 < n ? kB64[(v >> 6) & 63] : '=';
+          o[3] = i + 2 < n ? kB64[v & 63] : '=';
+        }
+        t += n;
+        tail_.store(t, std::memory_order_release);
+        emit(text_);
+      }
+    }
+
+  private:
+
+    bool begin_(std::size_t n) {
+      pos_ = head_.load(std::memory_order_relaxed);
+      if (pos_ + n - tail_.load(std::memory_order_acquire) > ring_.size()) { ++dropped_; return false; }
+      return true;
+    }
+    // Fills the kHeader bytes at o; returns the end.
+    static std::uint8_t *header_(std::uint8_t *o, std::size_t n, CaptureTag tag, std::size_t ticker, double clock) {
+      std::uint32_t size = std::uint32_t(n);
+      std::uint8_t  tk[4] = {std::uint8_t(tag), std::uint8_t(ticker), 0, 0};
+      std::memcpy(o, &size, sizeof size);
+      std::memcpy(o + 4, tk, sizeof tk);
+      std::memcpy(o + 8, &clock, sizeof clock);
+      return o + kHeader;
+    }
+    void write_(const void *p, std::size_t n) {
+      const std::uint8_t *b = static_cast<const std::uint8_t *>(p);
+      std::size_t at = pos_ % ring_.size(), first = std::min(n, ring_.size() - at);
+      std::memcpy(&ring_[at], b, first);
+      std::memcpy(&ring_[0], b + first, n - first);
+      pos_ += n;
+    }
+    void commit_() { head_.store(pos_, std::memory_order_release); }
+
+    std::vector<std::uint8_t> ring_;
+    std::size_t               high_water_;
+    std::atomic<std::size_t>  head_{0}, tail_{0};
+    std::size_t               pos_ = 0;       // write cursor of the record in progress
+    std::size_t               dropped_ = 0;
+    unsigned long long        seq_ = 0;
+    std::string               text_;
+  };
+
+  // Stand-in when capture is off.
+  struct NoCapture {
+    explicit NoCapture(std::size_t) {}
+  };
+};
+
+// ───────── Policies ─────────
+// Policies receive the cached TimeFactors rather than t_rem, so the only
+// transcendental left per evaluation is the sigmoid's exp.
+
+// Fair value: logistic in time-scaled lead, late-weighted momentum and home edge.
+struct LogisticFairValue {
+  static float sigmoid(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+
+  template <class C>
+  static float win_prob(const C &cfg, float lead, float momentum, const StrategyTypes::TimeFactors &tf,
+                        const StrategyTypes::RollingFeatures & /*rf*/) {
+    float xlead = lead * tf.scale;
+    float xmom  = tf.late * momentum;
+    float xhome = cfg.HOME_ADV_POINTS * tf.scale;
+
+    float logit = cfg.LOGIT_W_LEAD * xlead + cfg.LOGIT_W_MOM * xmom + cfg.LOGIT_W_HOME * xhome;
+    return std::clamp(sigmoid(logit), 0.01f, 0.99f);
+  }
+};
+
+// Fair value from a tree ensemble compiled in by sim/xgb2cpp. Model is the
+// generated struct: kFeatures inputs named by kInputs, kTrees roots into
+// kNodes, kBaseMargin, and kLogistic (sigmoid of the margin) or not (the
+// margin is the probability). Evaluated once per game event, not per book
+// update, because the strategy caches fair value between events.
+template <class Model>
+struct TreeFairValue {
+  template <class C>
+  static float win_prob(const C &cfg, float lead, float momentum, const StrategyTypes::TimeFactors &tf,
+                        const StrategyTypes::RollingFeatures &rf) {
+    using F = StrategyTypes::Feature;
+    using T = StrategyTypes::Team;
+    float x[Model::kFeatures];
+    for (int i = 0; i < Model::kFeatures; ++i) {
+      switch (Model::kInputs[i]) {
+        case F::LEAD:     x[i] = lead; break;
+        case F::MOMENTUM: x[i] = momentum; break;
+        case F::T_REM:    x[i] = tf.t_rem; break;
+        case F::HOME_ADV: x[i] = cfg.HOME_ADV_POINTS; break;
+        case F::RUN:        x[i] = float(rf.run()); break;
+        case F::HOME_PTS:   x[i] = float(rf.points(T::HOME)); break;
+        case F::AWAY_PTS:   x[i] = float(rf.points(T::AWAY)); break;
+        case F::HOME_FOULS: x[i] = float(rf.fouls(T::HOME)); break;
+        case F::AWAY_FOULS: x[i] = float(rf.fouls(T::AWAY)); break;
+        case F::HOME_TOV:   x[i] = float(rf.turnovers(T::HOME)); break;
+        case F::AWAY_TOV:   x[i] = float(rf.turnovers(T::AWAY)); break;
+        case F::HOME_3PM:   x[i] = float(rf.made(T::HOME, StrategyTypes::ShotType::THREE_POINT)); break;
+        case F::AWAY_3PM:   x[i] = float(rf.made(T::AWAY, StrategyTypes::ShotType::THREE_POINT)); break;
+        default:          x[i] = std::numeric_limits<float>::quiet_NaN(); break;
+      }
+    }
+    float m = Model::kBaseMargin + StrategyTypes::forest_sum(Model::kNodes, Model::kRoots, Model::kTrees, x);
+    float p = Model::kLogistic ? LogisticFairValue::sigmoid(m) : m;
+    return std::clamp(p, 0.01f, 0.99f);
+  }
+};
+
+// Sizing: a fixed share of capital, scaled by edge and late-game urgency.
+struct EdgeSizing {
+  template <class C>
+  static float contracts(const C &cfg, float edge, float ref_price, float capital,
+                         const StrategyTypes::TimeFactors &tf) {
+    if (ref_price <= 0.0f) return 0.0f;
+    float budget = capital * cfg.RISK_PCT_PER_TRADE;
+    float base   = std::max(1.0f, budget / std::max(1.0f, ref_price)); // contracts
+    float contracts = base * tf.urgency * (0.5f + std::min(1.5f, std::fabs(edge)/2.0f));
+    contracts = std::min(contracts, cfg.MAX_POS * 0.25f);
+    return std::max(0.0f, std::floor(contracts));
+  }
+};
+
+// CfgT is Cfg (static constexpr: every tunable constant-folds) or RuntimeCfg
+// (fields: one binary can sweep them). See Strategy / ResearchStrategy below.
+//
+// Per-ticker state is held structure-of-arrays, indexed by the Ticker enum
+// value, for CfgT::NUM_TICKERS tickers; callbacks for tickers outside that
+// range are ignored. Capital is account-wide. The sandbox's game-event
+// callback carries no ticker and feeds TEAM_A; native drivers running one
+// game per ticker call on_game_event(ev, ticker).
+template <class CfgT = StrategyTypes::Cfg, class FairValue = LogisticFairValue, class Sizing = EdgeSizing>
+class BasicStrategy : public StrategyTypes {
+public:
+  using Params = CfgT;
+  static constexpr std::size_t kTickers = std::size_t(Params::NUM_TICKERS);
+  static_assert(kTickers >= 1, "NUM_TICKERS must be at least 1");
+
+  // One passive order per side, as last sent. The quote layer compares the
+  // desired quote against this and only cancels or places on a change.
+  // `ahead` estimates the quantity queued in front of us at px: the level's
+  // size when we joined, less trade prints at px, and never more than the
+  // level now shows besides our own remainder.
+  struct WorkingOrder {
+    std::int64_t id;
+    Tick         px;
+    float        qty;    // as placed
+    float        left;   // qty minus fills seen since
+    float        ahead;  // estimated queue in front of us
+  };
+
+  // ───────── State ─────────
+  Params cfg_;
+  float  capital_remaining_ = 100000.0f;
+
+  // Market, per ticker
+  OB      book_[kTickers];
+  Account account_[kTickers];
+  double  game_pnl_[kTickers] = {};   // last finished game, see settle_()
+  std::optional<WorkingOrder> working_bid_[kTickers];
+  std::optional<WorkingOrder> working_ask_[kTickers];
+
+  // Game state, per ticker
+  float t_rem_[kTickers] = {};
+  TimeFactors tf_[kTickers];  // follows t_rem_, see set_t_rem_()
+  RollingFeatures features_[kTickers];
+  int   home_[kTickers] = {}, away_[kTickers] = {};
+  float lead_[kTickers] = {};
+  float momentum_[kTickers] = {};   // EMA of lead delta
+  bool  seen_event_[kTickers] = {};
+
+  // Model outputs, a function of game state only. Game events set
+  // model_dirty_; the next try_trade_ recomputes, book updates reuse.
+  bool  model_dirty_[kTickers] = {};
+  Fine  fair_fine_[kTickers] = {};
+  Fine  thr_fine_[kTickers] = {};
 
   // Control
+  int    book_pending_[kTickers] = {};   // book deltas applied since the last decision (coalescing)
+  double init_wall_[kTickers] = {};
   bool   inited_ = false;
-  double init_wall_ = 0.0;
 
-  // Track one passive order per side so we can cancel/refresh
-  std::optional<std::int64_t> working_bid_;
-  std::optional<std::int64_t> working_ask_;
+  // Latency histograms when Params::PROFILE_LATENCY, else an empty stand-in
+  std::conditional_t<Params::PROFILE_LATENCY, LatencyProfile, NoProfile> prof_;
 
-  // ───────── Lifecycle ─────────
-  void reset_state() {
-    book_.clear();
-    capital_remaining_ = 100000.0f;
-    position_ = 0.0f;
+  // Binary journal when Params::JOURNAL_RECORDS > 0; see record_()
+  static constexpr bool kJournal = Params::JOURNAL_RECORDS > 0;
+  std::conditional_t<kJournal, Journal, NoJournal> journal_{std::size_t(std::max(1, Params::JOURNAL_RECORDS))};
 
-    t_rem_ = Cfg::GAME_LEN2;
-    home_ = away_ = 0;
-    lead_ = 0.0f;
-    momentum_ = 0.0f;
-    seen_event_ = false;
+  // Event pricing for the high-impact fast path; built from cfg_ and FairValue
+  ReactionTable reactions_;
 
-    cancel_working_();
+  // Session capture when Params::CAPTURE_BYTES > 0; see capture_in_(). The
+  // strategy clock is then read once per inbound callback, into cb_clock_,
+  // so a replay that restores it per callback reproduces every timing check.
+  static constexpr bool kCapture = Params::CAPTURE_BYTES > 0;
+  std::conditional_t<kCapture, Capture, NoCapture> capture_{std::size_t(std::max(1, Params::CAPTURE_BYTES))};
+  double cb_clock_ = now_sec_();
 
+  // Background refit when Params::MODEL_REFIT_SEC > 0. fit_ is the parameter
+  // set win_prob_() reads then, taken from refit_ at each model refresh.
+  static constexpr bool kRefit = Params::MODEL_REFIT_SEC > 0.0f;
+  LogitParams fit_ = LogitParams::from(cfg_);
+  std::conditional_t<kRefit, ModelRefitter, NoRefitter> refit_{fit_, Params::MODEL_REFIT_SEC};
+
+  // ───────── Lifecycle ─────────
+  // Every piece of per-game state above is a fixed-size member, so the
+  // strategy object is its own arena: reset_state() rewinds it in place, and
+  // the only heap blocks (journal ring and text buffers) are sized at
+  // construction. Callbacks do not allocate; sim/bench --check-allocs
+  // verifies that across full replays.
+  void reset_state() {
+    capital_remaining_ = 100000.0f;
+    fit_ = LogitParams::from(cfg_);
+    fit_.gen = refit_.restart();
+    for (std::size_t k = 0; k < kTickers; ++k) reset_ticker_(k);
     inited_ = true;
-    init_wall_ = now_sec_();
   }
 
-  Strategy() { reset_state(); }
+  BasicStrategy() { start_(); }
+  explicit BasicStrategy(const Params &cfg) : cfg_(cfg) { start_(); }
+  virtual ~BasicStrategy() = default;
 
   // ───────── Callbacks (exact signatures from your template) ─────────
-  void on_trade_update(Ticker /*ticker*/, Side /*side*/, float /*quantity*/, float /*price*/) {
-    // Optional: println("trade...");
+  void on_trade_update(Ticker ticker, Side side, float quantity, float price) {
+    auto probe = prof_.scope(Probe::TRADE);
+    capture_in_(CaptureTag::TRADE, ticker, std::uint8_t(side), quantity, price);
+    std::size_t k;
+    if (!index_(ticker, k)) return;
+    record_(k, Probe::TRADE, side, price, quantity);
+    // A print at our price came out of the queue in front of us first
+    Tick t = to_tick_(price);
+    for (std::optional<WorkingOrder> *w : {&working_bid_[k], &working_ask_[k]})
+      if (*w && (*w)->px == t) (*w)->ahead = std::max(0.0f, (*w)->ahead - quantity);
+    flush_book_(k);
   }
 
+  // Every delta is checked for a cross. With COALESCE_BOOK_UPDATES > 0 the
+  // passive quote waits for the whole burst (a maker requote arrives as many
+  // deltas) instead of chasing each half-applied book: it is revisited when
+  // the next non-book callback arrives, or after COALESCE_BOOK_UPDATES
+  // deltas, whichever is first.
   void on_orderbook_update(Ticker ticker, Side side, float quantity, float price) {
-    if (ticker != Ticker::TEAM_A) return;
-    price = clamp_price_(price);
+    auto probe = prof_.scope(Probe::BOOK);
+    capture_in_(CaptureTag::BOOK, ticker, std::uint8_t(side), quantity, price);
+    std::size_t k;
+    if (!index_(ticker, k)) return;
+    Tick t = to_tick_(price);
 
-    if (side == Side::buy) {
-      if (quantity <= 0.0f) book_.bids.erase(price);
-      else                  book_.bids[price] = quantity;
-    } else {
-      if (quantity <= 0.0f) book_.asks.erase(price);
-      else                  book_.asks[price] = quantity;
-    }
-    try_trade_(/*event_high_impact=*/false);
+    if (side == Side::buy) book_[k].set_bid(t, quantity);
+    else                   book_[k].set_ask(t, quantity);
+    // A shrinking level can only leave so much in front of us
+    std::optional<WorkingOrder> &w = side == Side::buy ? working_bid_[k] : working_ask_[k];
+    if (w && w->px == t) w->ahead = std::min(w->ahead, std::max(0.0f, quantity - w->left));
+    record_(k, Probe::BOOK, side, price, quantity);
+    bool burst = cfg_.COALESCE_BOOK_UPDATES > 0 && ++book_pending_[k] < cfg_.COALESCE_BOOK_UPDATES;
+    try_trade_(k, /*event_high_impact=*/false, /*requote=*/!burst);
   }
 
-  void on_account_update(Ticker /*ticker*/, Side /*side*/, float /*price*/, float quantity,
+  void on_account_update(Ticker ticker, Side side, float price, float quantity,
                          float capital_remaining) {
+    auto probe = prof_.scope(Probe::ACCOUNT);
+    capture_in_(CaptureTag::ACCOUNT, ticker, std::uint8_t(side), price, quantity, capital_remaining);
     capital_remaining_ = capital_remaining;
-    position_ += quantity; // + for filled buys, - for sells (per engine)
+    std::size_t k;
+    if (!index_(ticker, k)) return;
+    account_[k].fill(quantity, price);
+    record_(k, Probe::ACCOUNT, side, price, quantity);
+    // Passive fills come at our resting price; forget a quote once it is used up
+    std::optional<WorkingOrder> &w = side == Side::buy ? working_bid_[k] : working_ask_[k];
+    if (w && to_tick_(price) == w->px) {
+      w->ahead = 0.0f;   // filling, so nothing is left in front
+      float left = w->left;
+      if ((w->left -= std::fabs(quantity)) < 1.0f) w.reset();
+      account_[k].release(side, w ? left - w->left : left);
+    }
     // If a passive filled, pull the sibling on that side
-    if (position_ > 0.0f && working_bid_) { cancel_order(Ticker::TEAM_A, *working_bid_); working_bid_.reset(); }
-    if (position_ < 0.0f && working_ask_) { cancel_order(Ticker::TEAM_A, *working_ask_); working_ask_.reset(); }
+    float pos = account_[k].position();
+    if (pos > 0.0f) set_quote_(k, Side::buy, 0, 0.0f);
+    if (pos < 0.0f) set_quote_(k, Side::sell, 0, 0.0f);
+    flush_book_(k);
   }
 
   virtual void on_game_event_update(
       const std::string& event_type,
-      const std::string& /*home_away*/,
+      const std::string& home_away,
       int home_score,
       int away_score,
       const std::optional<std::string>& /*player_name*/,
@@ -123,49 +1303,98 @@ public:
       const std::optional<std::string>& shot_type,
       const std::optional<std::string>& /*assist_player*/,
       const std::optional<std::string>& /*rebound_type*/,
-      const std::optional<double>& /*coordinate_x*/,
-      const std::optional<double>& /*coordinate_y*/,
+      const std::optional<double>& coordinate_x,
+      const std::optional<double>& coordinate_y,
       const std::optional<double>& time_seconds
   ) {
-    if (time_seconds.has_value()) {
-      float t = static_cast<float>(*time_seconds);
-      if (t <= Cfg::GAME_LEN1 + 1.0f) t_rem_ = t;
-      if (t <= Cfg::GAME_LEN2 + 1.0f) t_rem_ = std::max(t_rem_, t);
+    GameEvent ev;
+    ev.type = classify_event(event_type);
+    ev.team = classify_team(home_away);
+    ev.shot = shot_type ? classify_shot(*shot_type) : ShotType::NONE;
+    ev.home_score = home_score;
+    ev.away_score = away_score;
+    ev.coordinate_x = coordinate_x;
+    ev.coordinate_y = coordinate_y;
+    ev.time_seconds = time_seconds;
+    on_game_event(ev);
+  }
+
+  void on_game_event(const GameEvent& ev, Ticker ticker = Ticker::TEAM_A) {
+    auto probe = prof_.scope(Probe::GAME);
+    if constexpr (kCapture) {
+      std::uint8_t has = std::uint8_t(ev.coordinate_x.has_value() | ev.coordinate_y.has_value() << 1 |
+                                      ev.time_seconds.has_value() << 2);
+      capture_in_(CaptureTag::GAME, ticker, std::uint8_t(ev.type), std::uint8_t(ev.team), std::uint8_t(ev.shot), has,
+                  std::int32_t(ev.home_score), std::int32_t(ev.away_score), ev.coordinate_x.value_or(0.0),
+                  ev.coordinate_y.value_or(0.0), ev.time_seconds.value_or(0.0));
+    }
+    std::size_t k;
+    if (!index_(ticker, k)) return;
+
+    if (ev.time_seconds.has_value()) {
+      float t = static_cast<float>(*ev.time_seconds);
+      float t_rem = t_rem_[k];
+      if (t <= Cfg::GAME_LEN1 + 1.0f) t_rem = t;
+      if (t <= Cfg::GAME_LEN2 + 1.0f) t_rem = std::max(t_rem, t);
+      if (t_rem != t_rem_[k]) set_t_rem_(k, t_rem);
     }
 
     // Momentum / score
-    float prev_lead = lead_;
-    home_ = home_score; away_ = away_score;
-    lead_ = float(home_ - away_);
-    if (seen_event_) {
-      float dlead = lead_ - prev_lead;
-      float a = Cfg::MOM_EMA_ALPHA;
-      momentum_ = (1.0f - a) * momentum_ + a * dlead;
+    float prev_lead = lead_[k];
+    home_[k] = ev.home_score; away_[k] = ev.away_score;
+    lead_[k] = float(home_[k] - away_[k]);
+    if (seen_event_[k]) {
+      float dlead = lead_[k] - prev_lead;
+      float a = cfg_.MOM_EMA_ALPHA;
+      momentum_[k] = (1.0f - a) * momentum_[k] + a * dlead;
     } else {
-      momentum_ = 0.0f;
-      seen_event_ = true;
+      momentum_[k] = 0.0f;
+      seen_event_[k] = true;
     }
+    features_[k].on_event(ev);
+    model_dirty_[k] = true;
+    record_(k, Probe::GAME, Side::buy, float(home_[k]), float(away_[k]));
 
-    // End handling first
-    if (event_type == "END_GAME") {
-      flatten_all_();
-      reset_state();
+    // End handling first; with a single ticker the whole account resets
+    if (ev.type == EventType::END_GAME) {
+      settle_(k);
+      flatten_(k);
+      flush_journal_();
+      flush_capture_();
+      if constexpr (Params::PROFILE_LATENCY) {
+        println(prof_.report("latency ns, last game:"));
+        prof_.clear();
+      }
+      if (kTickers == 1) reset_state();
+      else               reset_ticker_(k);
       return;
     }
-    if (t_rem_ <= Cfg::CLOSE_OUT_BUFFER_SEC) {
-      flatten_all_();
+    if (t_rem_[k] <= cfg_.CLOSE_OUT_BUFFER_SEC) {
+      book_pending_[k] = 0;
+      flatten_(k);
       return;
     }
 
     // High-impact detector
     bool high_impact = false;
-    if (event_type == "SCORE") {
-      if ((shot_type && *shot_type == "THREE_POINT") || t_rem_ < 30.0f) high_impact = true;
-    } else if (event_type == "TURNOVER" || event_type == "STEAL" || event_type == "FOUL") {
-      if (t_rem_ < 45.0f) high_impact = true;
+    switch (ev.type) {
+      case EventType::SCORE:
+        high_impact = ev.shot == ShotType::THREE_POINT || t_rem_[k] < 30.0f;
+        break;
+      case EventType::TURNOVER:
+      case EventType::STEAL:
+      case EventType::FOUL:
+        high_impact = t_rem_[k] < 45.0f;
+        break;
+      default:
+        break;
     }
 
-    try_trade_(high_impact);
+    if (high_impact && react_(k, ev, int(lead_[k] - prev_lead))) {
+      refresh_model_(k);   // the order is out; catch the model up
+      return;
+    }
+    try_trade_(k, high_impact);
   }
 
   virtual void on_orderbook_snapshot(
@@ -173,164 +1402,439 @@ public:
       const vector<pair<float, float>>& bids,
       const vector<pair<float, float>>& asks)
   {
-    if (ticker != Ticker::TEAM_A) return;
-    book_.clear();
-    for (const auto &pq : bids) if (pq.second >= Cfg::MIN_BOOK_QTY) book_.bids[pq.first] = pq.second;
-    for (const auto &pq : asks) if (pq.second >= Cfg::MIN_BOOK_QTY) book_.asks[pq.first] = pq.second;
-    try_trade_(/*event_high_impact=*/false);
+    auto probe = prof_.scope(Probe::SNAPSHOT);
+    if constexpr (kCapture) {
+      cb_clock_ = now_sec_();
+      capture_.put_snapshot(std::size_t(ticker), cb_clock_, bids, asks);
+      if (capture_.above_high_water()) flush_capture_();
+    }
+    std::size_t k;
+    if (!index_(ticker, k)) return;
+    OB &book = book_[k];
+    book.begin_snapshot();
+    for (const auto &pq : bids) book.snap_bid(to_tick_(pq.first), pq.second);
+    for (const auto &pq : asks) book.snap_ask(to_tick_(pq.first), pq.second);
+    book.end_snapshot();
+    record_(k, Probe::SNAPSHOT, Side::buy, book.top().mid, float(bids.size() + asks.size()));
+    try_trade_(k, /*event_high_impact=*/false);
   }
 
 private:
   // ───────── Helpers ─────────
+  // Offline drivers define KWOKKER_NOW_SEC() to run the cooldown on simulated time.
   static double now_sec_() {
+#ifdef KWOKKER_NOW_SEC
+    return KWOKKER_NOW_SEC();
+#else
     using namespace std::chrono;
     return duration<double>(steady_clock::now().time_since_epoch()).count();
+#endif
   }
 
-  static float clamp_price_(float x) { return std::clamp(x, 0.0f, 100.0f); }
+  // Strategy clock: the time of the current callback when capturing, else now.
+  double clock_() const {
+    if constexpr (kCapture) return cb_clock_;
+    else                    return now_sec_();
+  }
 
-  std::optional<float> best_bid_() const {
-    for (auto &kv : book_.bids) if (kv.second >= Cfg::MIN_BOOK_QTY) return kv.first;
-    return std::nullopt;
+  void start_() {
+    if constexpr (kCapture) capture_.put(CaptureTag::START, 0, cb_clock_);
+    build_reactions_();
+    reset_state();
   }
-  std::optional<float> best_ask_() const {
-    for (auto &kv : book_.asks) if (kv.second >= Cfg::MIN_BOOK_QTY) return kv.first;
-    return std::nullopt;
+
+  // Capture one inbound callback, stamping the clock it will run on.
+  template <class... F>
+  void capture_in_(CaptureTag tag, Ticker ticker, const F &...fields) {
+    if constexpr (kCapture) {
+      cb_clock_ = now_sec_();
+      capture_.put(tag, std::size_t(ticker), cb_clock_, fields...);
+      if (capture_.above_high_water()) flush_capture_();
+    }
   }
-  std::optional<float> mid_() const {
-    auto bb = best_bid_(), aa = best_ask_();
-    if (bb && aa) return (*bb + *aa) * 0.5f;
-    return std::nullopt;
+  void flush_capture_() {
+    if constexpr (kCapture) capture_.drain([](const std::string &line) { println(line); });
   }
 
-  static float sigmoid_(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+  // Order calls, captured with their results when capturing.
+  bool send_market_(Side side, std::size_t k, float qty) {
+    bool ok = place_market_order(side, ticker_(k), qty);
+    if constexpr (kCapture) capture_.put(CaptureTag::MARKET, k, cb_clock_, std::uint8_t(side), qty, std::uint8_t(ok));
+    return ok;
+  }
+  std::int64_t send_limit_(Side side, std::size_t k, float qty, float price, bool ioc) {
+    std::int64_t id = place_limit_order(side, ticker_(k), qty, price, ioc);
+    if constexpr (kCapture)
+      capture_.put(CaptureTag::LIMIT, k, cb_clock_, std::uint8_t(side), qty, price, std::uint8_t(ioc), id);
+    return id;
+  }
+  bool send_cancel_(std::size_t k, std::int64_t id) {
+    bool ok = cancel_order(ticker_(k), id);
+    if constexpr (kCapture) capture_.put(CaptureTag::CANCEL, k, cb_clock_, id, std::uint8_t(ok));
+    return ok;
+  }
 
-  float win_prob_() const {
-    float t = std::max(t_rem_, 0.0f);
-    float scale = 1.0f / std::sqrt((t / 60.0f) + 1.0f);      // minutes-ish
-    float xlead = lead_ * scale;
-    float late  = 1.0f + (1.0f - std::tanh(t / 600.0f));     // more weight late
-    float xmom  = late * momentum_;
-    float xhome = Cfg::HOME_ADV_POINTS * scale;
+  static bool index_(Ticker t, std::size_t &k) {
+    k = std::size_t(t);
+    return k < kTickers;
+  }
+  static Ticker ticker_(std::size_t k) { return static_cast<Ticker>(k); }
 
-    float logit = 0.18f * xlead + 0.10f * xmom + 0.20f * xhome;
-    return std::clamp(sigmoid_(logit), 0.01f, 0.99f);
+  // Nearest tick, clamped to [0, 100]. The only float->tick conversion.
+  static Tick to_tick_(float price) {
+    return Tick(std::clamp(long(std::lround(price / Cfg::PRICE_TICK)), 0L, long(Cfg::MAX_TICK)));
   }
+  static float to_price_(Tick t) { return float(t) * Cfg::PRICE_TICK; }
+  // Nearest hundredth of a tick; fair values and thresholds only.
+  static Fine  to_fine_(float price) { return Fine(std::lround(price * (float(kFinePerTick) / Cfg::PRICE_TICK))); }
+  static Fine  fine_(Tick t) { return Fine(t) * kFinePerTick; }
+  static float fine_price_(Fine f) { return float(f) * (Cfg::PRICE_TICK / float(kFinePerTick)); }
+  static Tick clamp_tick_(int t) { return Tick(std::clamp(t, 0, int(Cfg::MAX_TICK))); }
 
-  float fair_price_() const { return 100.0f * win_prob_(); }
+  void reset_ticker_(std::size_t k) {
+    book_[k].clear();
 
-  float edge_threshold_() const {
-    float t = std::max(t_rem_, 0.0f);
-    float late_fac = 1.0f - Cfg::LATE_TIGHTEN * (1.0f - std::tanh(t / 600.0f));
-    return std::max(0.2f, Cfg::BASE_EDGE_THRESH * late_fac);
+    set_t_rem_(k, Cfg::GAME_LEN2);
+    home_[k] = away_[k] = 0;
+    lead_[k] = 0.0f;
+    momentum_[k] = 0.0f;
+    seen_event_[k] = false;
+    book_pending_[k] = 0;
+    features_[k].reset(cfg_.FEATURE_WINDOW_SEC);
+    model_dirty_[k] = true;
+
+    cancel_working_(k);
+    account_[k].reset();
+    init_wall_[k] = clock_();
+    refresh_model_(k);   // the fast path prices events off fair_fine_
   }
 
-  float target_size_for_edge_(float edge, float ref_price) const {
-    if (ref_price <= 0.0f) return 0.0f;
-    float budget = capital_remaining_ * Cfg::RISK_PCT_PER_TRADE;
-    float base   = std::max(1.0f, budget / std::max(1.0f, ref_price)); // contracts
-    float t = std::max(t_rem_, 0.0f);
-    float urgency = 1.0f + (1.0f - std::tanh(t / 800.0f));             // ~1→2
-    float contracts = base * urgency * (0.5f + std::min(1.5f, std::fabs(edge)/2.0f));
-    contracts = std::min(contracts, Cfg::MAX_POS * 0.25f);
-    return std::max(0.0f, std::floor(contracts));
+  // The only writer of t_rem_ after construction; keeps tf_ in step.
+  void set_t_rem_(std::size_t k, float t) {
+    t_rem_[k] = t;
+    tf_[k] = TimeFactors::at(cfg_, t);
+    model_dirty_[k] = true;
+  }
+
+  // Past the start-of-game cooldown; decisions wait for it.
+  bool ready_(std::size_t k) const { return inited_ && clock_() - init_wall_[k] >= cfg_.INIT_COOLDOWN_SEC; }
+
+  // One table entry per (class, time bucket, lead): the policy's price after
+  // the event less its price before, both at the bucket's middle time.
+  void build_reactions_() {
+    if constexpr (!Params::REACT_FAST) return;
+    using RT = ReactionTable;
+    constexpr int kPts[] = {1, 2, 3, -1, -2, -3};
+    static_assert(std::size(kPts) == RT::kClasses);
+    constexpr ShotType kShot[] = {ShotType::FREE_THROW, ShotType::TWO_POINT, ShotType::THREE_POINT};
+    RollingFeatures empty;
+    empty.reset(cfg_.FEATURE_WINDOW_SEC);
+    for (int c = 0; c < RT::kClasses; ++c) {
+      for (int tb = 0; tb < RT::kTimeBuckets; ++tb) {
+        float t = RT::time_mid(tb);
+        TimeFactors tf = TimeFactors::at(cfg_, t);
+        GameEvent ev;
+        ev.time_seconds = double(t);
+        int d = kPts[c];
+        ev.type = EventType::SCORE;
+        ev.team = d > 0 ? Team::HOME : Team::AWAY;
+        ev.shot = kShot[std::abs(d) - 1];
+        (d > 0 ? ev.home_score : ev.away_score) = std::abs(d);
+        RollingFeatures after = empty;
+        after.on_event(ev);
+        for (int lb = 0; lb < RT::kLeads; ++lb) {
+          float lead = float(lb - RT::kMaxLead);
+          float p0 = FairValue::win_prob(cfg_, lead, 0.0f, tf, empty);
+          float p1 = FairValue::win_prob(cfg_, lead + float(d), cfg_.MOM_EMA_ALPHA * float(d), tf, after);
+          reactions_.set(c, tb, lb, int(std::lround(100.0f * (p1 - p0) / Cfg::PRICE_TICK)));
+        }
+      }
+    }
+  }
+
+  // High-impact fast path: price the event as last fair value plus its table
+  // jump and, if that clears the edge threshold against the cached top, send
+  // the IOC cross before the model runs. True if an order went out; the
+  // caller then refreshes the model, and the next book update decides as usual.
+  // In the last minute try_trade_ decides instead, so the late-game inventory
+  // nudges still apply.
+  bool react_(std::size_t k, const GameEvent &ev, int dlead) {
+    if constexpr (!Params::REACT_FAST) return false;
+    auto probe = prof_.scope(Probe::REACT);
+    int cls = ReactionTable::class_of(ev, dlead);
+    if (cls < 0 || !ready_(k) || t_rem_[k] < 60.0f) return false;
+    const OB::Top &top = book_[k].top();
+    if (!top.ok) return false;
+
+    Fine  jump = reactions_.jump(cls, t_rem_[k], lead_[k] - float(dlead)) * kFinePerTick;
+    Fine  fair = std::clamp(fair_fine_[k] + jump, Fine(0), Fine(Cfg::MAX_TICK) * kFinePerTick);
+    Fine  thr  = edge_threshold_fine_(k);
+    float pos  = account_[k].position();
+    Fine  edge_up = fair - fine_(top.ask), edge_down = fine_(top.bid) - fair;
+    Side  side;
+    Fine  edge;
+    if (edge_up > thr && pos < cfg_.MAX_POS)         { side = Side::buy;  edge = edge_up; }
+    else if (edge_down > thr && pos > -cfg_.MAX_POS) { side = Side::sell; edge = edge_down; }
+    else return false;
+
+    float qty = target_size_for_edge_(k, side, edge, top.mid);
+    if (qty < 1.0f) return false;
+    Tick px = side == Side::buy ? top.ask : top.bid;
+    cancel_working_(k);
+    send_limit_(side, k, qty, to_price_(px), /*ioc=*/true);
+    record_(k, Probe::REACT, side, to_price_(px), qty, fine_price_(edge));
+    return true;
+  }
+
+  void refresh_model_(std::size_t k) {
+    if (!model_dirty_[k]) return;
+    fair_fine_[k] = to_fine_(fair_price_(k));
+    thr_fine_[k] = edge_threshold_fine_(k);
+    model_dirty_[k] = false;
+  }
+
+  float win_prob_(std::size_t k) const {
+    if constexpr (kRefit) return FairValue::win_prob(fit_, lead_[k], momentum_[k], tf_[k], features_[k]);
+    else                  return FairValue::win_prob(cfg_, lead_[k], momentum_[k], tf_[k], features_[k]);
+  }
+
+  // Refit hand-off: post this refresh's inputs and the market's price, and
+  // take any newer parameter set (which invalidates every cached fair value).
+  void exchange_refit_(std::size_t k, float mid) {
+    if constexpr (kRefit) {
+      const TimeFactors &tf = tf_[k];
+      refit_.observe(Observation{lead_[k] * tf.scale, tf.late * momentum_[k], tf.scale, mid, fit_.gen});
+      if (refit_.poll(fit_))
+        for (std::size_t j = 0; j < kTickers; ++j) model_dirty_[j] = true;
+    }
+  }
+
+  float fair_price_(std::size_t k) const { return 100.0f * win_prob_(k); }
+
+  float edge_threshold_(std::size_t k) const { return std::max(0.2f, cfg_.BASE_EDGE_THRESH * tf_[k].late_fac); }
+
+  Fine edge_threshold_fine_(std::size_t k) const { return to_fine_(edge_threshold_(k)); }
+
+  // Contracts for an order on `side`, capped by the room left under MAX_POS.
+  // Every order we send replaces that side's own resting quote (crosses
+  // cancel it first), so only the position and other resting orders count.
+  float target_size_for_edge_(std::size_t k, Side side, Fine edge, float ref_price) const {
+    const std::optional<WorkingOrder> &w = side == Side::buy ? working_bid_[k] : working_ask_[k];
+    float room = account_[k].room(side, cfg_.MAX_POS, w ? w->left : 0.0f);
+    return std::min(Sizing::contracts(cfg_, fine_price_(edge), ref_price, capital_remaining_, tf_[k]), room);
   }
 
-  void cancel_working_() {
-    if (working_bid_) { cancel_order(Ticker::TEAM_A, *working_bid_); working_bid_.reset(); }
-    if (working_ask_) { cancel_order(Ticker::TEAM_A, *working_ask_); working_ask_.reset(); }
+  // Journal one callback or decision for slot k; compiles away when off.
+  // Flushes through println once the ring passes its high-water mark.
+  void record_(std::size_t k, Probe kind, Side side, float price, float qty, float edge = 0.0f) {
+    if constexpr (kJournal) {
+      journal_.push(JournalRecord{clock_(), t_rem_[k], price, qty, account_[k].position(), fine_price_(fair_fine_[k]),
+                                  edge, kind, std::uint8_t(side == Side::sell), std::uint8_t(k)});
+      if (journal_.above_high_water()) flush_journal_();
+    }
+  }
+  void flush_journal_() {
+    if constexpr (kJournal) {
+      if (journal_.size() > 0) println(journal_.drain("journal"));
+    }
   }
 
-  void flatten_all_() {
-    cancel_working_();
-    if (std::fabs(position_) >= 1.0f) {
-      if (position_ > 0.0f) place_market_order(Side::sell, Ticker::TEAM_A, std::floor(position_));
-      else                  place_market_order(Side::buy,  Ticker::TEAM_A, std::floor(-position_));
+  // Bring one side's resting quote to (px, qty); qty < 1 means no quote.
+  // A quote already resting qty at px sends nothing; anything else, a
+  // partly filled one included, is cancel + place. (keep_quote_ is where a
+  // partly filled quote may be left alone for its queue position.)
+  void set_quote_(std::size_t k, Side side, Tick px, float qty, float edge = 0.0f) {
+    std::optional<WorkingOrder> &w = side == Side::buy ? working_bid_[k] : working_ask_[k];
+    bool want = qty >= 1.0f;
+    if (want && w && w->px == px && w->left == qty) return;
+    if (w) {
+      send_cancel_(k, w->id);
+      account_[k].release(side, w->left);
+      w.reset();
     }
+    if (!want) return;
+    std::int64_t id = send_limit_(side, k, qty, to_price_(px), /*ioc=*/false);
+    if (id >= 0) {
+      w = WorkingOrder{id, px, qty, qty, level_qty_(k, side, px)};
+      account_[k].hold(side, qty);
+    }
+    record_(k, Probe::PASSIVE, side, to_price_(px), qty, edge);
   }
 
-  void maybe_place_passives_(float fair, float bestBid, float bestAsk, float midp) {
-    float e_buy  = fair - bestAsk;
-    float e_sell = bestBid - fair;
-    float thr = edge_threshold_();
+  float level_qty_(std::size_t k, Side side, Tick px) const {
+    return side == Side::buy ? book_[k].bids[px] : book_[k].asks[px];
+  }
+
+  // Rough chance a quote fills before the market moves: halves for every
+  // QUEUE_HALF_QTY contracts ahead of it and for every tick it sits behind
+  // the best price others show.
+  float fill_prob_(float ahead, int ticks_behind) const {
+    return std::ldexp(1.0f, -std::max(0, ticks_behind)) / (1.0f + ahead / cfg_.QUEUE_HALF_QTY);
+  }
+
+  // Whether to leave this side's working quote in place rather than move it
+  // to (px, qty). Moving loses queue priority, so it has to buy at least
+  // REQUOTE_HURDLE more expected edge (fill chance x edge per contract). A
+  // quote that no longer clears the edge threshold, is priced through the
+  // wanted one, or is larger than the position limit now allows always moves.
+  bool keep_quote_(std::size_t k, Side side, Tick px, float qty, Fine fair, Fine thr, Tick best_other) const {
+    const std::optional<WorkingOrder> &w = side == Side::buy ? working_bid_[k] : working_ask_[k];
+    if (!w) return false;
+    bool buy = side == Side::buy;
+    Fine edge_keep = buy ? fair - fine_(w->px) : fine_(w->px) - fair;
+    Fine edge_new  = buy ? fair - fine_(px) : fine_(px) - fair;
+    if (edge_keep <= thr || edge_keep < edge_new || w->left > qty) return false;
+    float p_keep = fill_prob_(w->ahead, buy ? best_other - w->px : w->px - best_other);
+    float p_new  = fill_prob_(level_qty_(k, side, px), buy ? best_other - px : px - best_other);
+    return p_keep * float(edge_keep) >= (1.0f - cfg_.REQUOTE_HURDLE) * p_new * float(edge_new);
+  }
 
-    if (e_buy > e_sell && e_buy > thr && position_ < Cfg::MAX_POS) {
-      float px  = clamp_price_(bestBid + Cfg::PASSIVE_IMPROVE);
-      float qty = target_size_for_edge_(e_buy, midp);
-      qty = std::min(qty, Cfg::MAX_POS - position_);
+  void cancel_working_(std::size_t k) {
+    set_quote_(k, Side::buy, 0, 0.0f);
+    set_quote_(k, Side::sell, 0, 0.0f);
+  }
+
+  // The game's PnL by our own books: realized plus the position marked at the
+  // contract's settlement (100 on a home win), before the close-out order.
+  void settle_(std::size_t k) {
+    game_pnl_[k] = account_[k].pnl(home_[k] > away_[k] ? 100.0f : 0.0f);
+  }
+
+  void flatten_(std::size_t k) {
+    auto probe = prof_.scope(Probe::FLATTEN);
+    cancel_working_(k);
+    float pos = account_[k].position();
+    if (std::fabs(pos) >= 1.0f) {
+      Side side = pos > 0.0f ? Side::sell : Side::buy;
+      send_market_(side, k, std::floor(std::fabs(pos)));
+      record_(k, Probe::FLATTEN, side, 0.0f, std::floor(std::fabs(pos)));
+    }
+  }
+
+  // Best level on a side with our own resting quote taken out, so a quote
+  // never prices or sizes off itself (and then chases itself every update).
+  Tick others_best_bid_(std::size_t k, Tick best) const {
+    const std::optional<WorkingOrder> &w = working_bid_[k];
+    if (!w || w->px != best || book_[k].bids[best] - w->left >= Cfg::MIN_BOOK_QTY) return best;
+    Tick t = Tick(best - 1);
+    while (t >= 0 && book_[k].bids[t] < Cfg::MIN_BOOK_QTY) --t;
+    return t;
+  }
+  Tick others_best_ask_(std::size_t k, Tick best) const {
+    const std::optional<WorkingOrder> &w = working_ask_[k];
+    if (!w || w->px != best || book_[k].asks[best] - w->left >= Cfg::MIN_BOOK_QTY) return best;
+    Tick t = Tick(best + 1);
+    while (t < OB::LEVELS && book_[k].asks[t] < Cfg::MIN_BOOK_QTY) ++t;
+    return t;
+  }
+
+  void maybe_place_passives_(std::size_t k, Fine fair, Tick topBid, Tick topAsk, float topMid, Fine thr) {
+    auto probe = prof_.scope(Probe::PASSIVE);
+    Tick  bestBid = others_best_bid_(k, topBid), bestAsk = others_best_ask_(k, topAsk);
+    float midp = bestBid >= 0 && bestAsk < OB::LEVELS ? to_price_(Tick(bestBid + bestAsk)) * 0.5f : topMid;
+    float pos = account_[k].position();
+    Fine e_buy  = fair - fine_(bestAsk);
+    Fine e_sell = fine_(bestBid) - fair;
+
+    if (e_buy > e_sell && e_buy > thr && pos < cfg_.MAX_POS) {
+      Tick  px  = clamp_tick_(bestBid + cfg_.PASSIVE_IMPROVE);
+      float qty = target_size_for_edge_(k, Side::buy, e_buy, midp);
       if (qty >= 1.0f) {
-        if (working_bid_) cancel_order(Ticker::TEAM_A, *working_bid_);
-        if (working_ask_) { cancel_order(Ticker::TEAM_A, *working_ask_); working_ask_.reset(); }
-        std::int64_t id = place_limit_order(Side::buy, Ticker::TEAM_A, qty, px, /*ioc=*/false);
-        if (id >= 0) working_bid_ = id;
+        set_quote_(k, Side::sell, 0, 0.0f);
+        if (!keep_quote_(k, Side::buy, px, qty, fair, thr, bestBid))
+          set_quote_(k, Side::buy, px, qty, fine_price_(e_buy));
       }
-    } else if (e_sell > thr && position_ > -Cfg::MAX_POS) {
-      float px  = clamp_price_(bestAsk - Cfg::PASSIVE_IMPROVE);
-      float qty = target_size_for_edge_(e_sell, midp);
-      qty = std::min(qty, position_ + Cfg::MAX_POS);
+    } else if (e_sell > thr && pos > -cfg_.MAX_POS) {
+      Tick  px  = clamp_tick_(bestAsk - cfg_.PASSIVE_IMPROVE);
+      float qty = target_size_for_edge_(k, Side::sell, e_sell, midp);
       if (qty >= 1.0f) {
-        if (working_ask_) cancel_order(Ticker::TEAM_A, *working_ask_);
-        if (working_bid_) { cancel_order(Ticker::TEAM_A, *working_bid_); working_bid_.reset(); }
-        std::int64_t id = place_limit_order(Side::sell, Ticker::TEAM_A, qty, px, /*ioc=*/false);
-        if (id >= 0) working_ask_ = id;
+        set_quote_(k, Side::buy, 0, 0.0f);
+        if (!keep_quote_(k, Side::sell, px, qty, fair, thr, bestAsk))
+          set_quote_(k, Side::sell, px, qty, fine_price_(e_sell));
       }
     } else {
-      cancel_working_();
+      cancel_working_(k);
     }
   }
 
-  void try_trade_(bool event_high_impact) {
-    if (!inited_) return;
-    if (now_sec_() - init_wall_ < Cfg::INIT_COOLDOWN_SEC) return;
+  // Decide on a coalesced book burst, if one is pending.
+  void flush_book_(std::size_t k) {
+    if (book_pending_[k] > 0) try_trade_(k, /*event_high_impact=*/false);
+  }
+
+  void try_trade_(std::size_t k, bool event_high_impact, bool requote = true) {
+    auto probe = prof_.scope(Probe::DECIDE);
+    int pending = book_pending_[k];
+    book_pending_[k] = 0;
+    if (!ready_(k)) return;
 
-    auto bb = best_bid_(), aa = best_ask_(), mm = mid_();
-    if (!(bb && aa && mm)) return;
+    const OB::Top &top = book_[k].top();
+    if (!top.ok) return;
 
-    float bestBid = *bb, bestAsk = *aa, midp = *mm;
-    float spread = std::max(0.0f, bestAsk - bestBid);
-    float fair   = fair_price_();
-    float thr    = edge_threshold_();
+    Tick  bestBid = top.bid, bestAsk = top.ask, spread = top.spread;
+    float midp    = top.mid;
+    if (model_dirty_[k]) exchange_refit_(k, midp);
+    refresh_model_(k);
+    Fine  fair    = fair_fine_[k];
+    Fine  thr     = thr_fine_[k];
+    float pos     = account_[k].position();
 
-    float edge_up   = fair - bestAsk; // positive → buy
-    float edge_down = bestBid - fair; // positive → sell
+    Fine edge_up   = fair - fine_(bestAsk); // positive → buy
+    Fine edge_down = fine_(bestBid) - fair; // positive → sell
 
     // Late-game inventory nudges
-    if (t_rem_ < 60.0f) {
-      if (position_ > 0.5f && fair < bestBid) {
-        float qty = std::floor(std::max(1.0f, position_ * Cfg::POSITION_NUDGE_LATE));
-        place_market_order(Side::sell, Ticker::TEAM_A, qty);
+    if (t_rem_[k] < 60.0f) {
+      if (pos > 0.5f && fair < fine_(bestBid)) {
+        auto nudge = prof_.scope(Probe::NUDGE);
+        float qty = std::floor(std::max(1.0f, pos * cfg_.POSITION_NUDGE_LATE));
+        send_market_(Side::sell, k, qty);
+        record_(k, Probe::NUDGE, Side::sell, to_price_(bestBid), qty, fine_price_(edge_down));
         return;
-      } else if (position_ < 0.0f && fair > bestAsk) {
-        float qty = std::floor(std::max(1.0f, -position_ * Cfg::POSITION_NUDGE_LATE));
-        place_market_order(Side::buy, Ticker::TEAM_A, qty);
+      } else if (pos < 0.0f && fair > fine_(bestAsk)) {
+        auto nudge = prof_.scope(Probe::NUDGE);
+        float qty = std::floor(std::max(1.0f, -pos * cfg_.POSITION_NUDGE_LATE));
+        send_market_(Side::buy, k, qty);
+        record_(k, Probe::NUDGE, Side::buy, to_price_(bestAsk), qty, fine_price_(edge_up));
         return;
       }
     }
 
-    bool allow_cross = (spread <= Cfg::MAX_SPREAD_TO_CROSS) || event_high_impact;
+    bool allow_cross = (spread <= cfg_.MAX_SPREAD_TO_CROSS) || event_high_impact;
 
     if (allow_cross) {
-      if (edge_up > thr && position_ < Cfg::MAX_POS) {
-        float qty = target_size_for_edge_(edge_up, midp);
-        qty = std::min(qty, Cfg::MAX_POS - position_);
+      if (edge_up > thr && pos < cfg_.MAX_POS) {
+        float qty = target_size_for_edge_(k, Side::buy, edge_up, midp);
         if (qty >= 1.0f) {
-          cancel_working_();
-          place_limit_order(Side::buy, Ticker::TEAM_A, qty, bestAsk, /*ioc=*/true);
+          auto cross = prof_.scope(Probe::CROSS);
+          cancel_working_(k);
+          send_limit_(Side::buy, k, qty, to_price_(bestAsk), /*ioc=*/true);
+          record_(k, Probe::CROSS, Side::buy, to_price_(bestAsk), qty, fine_price_(edge_up));
           return;
         }
       }
-      if (edge_down > thr && position_ > -Cfg::MAX_POS) {
-        float qty = target_size_for_edge_(edge_down, midp);
-        qty = std::min(qty, position_ + Cfg::MAX_POS);
+      if (edge_down > thr && pos > -cfg_.MAX_POS) {
+        float qty = target_size_for_edge_(k, Side::sell, edge_down, midp);
         if (qty >= 1.0f) {
-          cancel_working_();
-          place_limit_order(Side::sell, Ticker::TEAM_A, qty, bestBid, /*ioc=*/true);
+          auto cross = prof_.scope(Probe::CROSS);
+          cancel_working_(k);
+          send_limit_(Side::sell, k, qty, to_price_(bestBid), /*ioc=*/true);
+          record_(k, Probe::CROSS, Side::sell, to_price_(bestBid), qty, fine_price_(edge_down));
           return;
         }
       }
     }
 
-    // Otherwise rest passively
-    maybe_place_passives_(fair, bestBid, bestAsk, midp);
+    // Otherwise rest passively, once the burst is in
+    if (requote) maybe_place_passives_(k, fair, bestBid, bestAsk, midp, thr);
+    else         book_pending_[k] = pending;
   }
 };
+
+// Production build: the class the sandbox instantiates.
+class Strategy : public BasicStrategy<> {
+public:
+  using BasicStrategy::BasicStrategy;
+};
+
+// Research build of the same source, with tunables read at runtime.
+using ResearchStrategy = BasicStrategy<StrategyTypes::RuntimeCfg>;
@@ -0,0 +1,66 @@
+// ---- alloc_count.hpp (global operator new counting) ---------------------------
+// Replaces the global allocation functions with malloc-backed ones that count
+// calls and bytes per thread, so tools can report heap traffic per operation.
+// Replacement functions must be defined once per program: include this from
+// exactly one translation unit (the tool's main file), never from a header.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace sim {
+
+struct AllocCount {
+  std::uint64_t calls = 0, bytes = 0;
+
+  AllocCount operator-(const AllocCount &o) const { return {calls - o.calls, bytes - o.bytes}; }
+};
+
+inline thread_local AllocCount g_allocs;
+inline thread_local int g_allocs_paused = 0;
+
+// Allocations made by this thread so far, outside AllocPause scopes.
+inline AllocCount allocs() { return g_allocs; }
+
+// Allocations inside this scope are not counted (e.g. the venue side of a
+// strategy's order call, when only the strategy is being checked).
+struct AllocPause {
+  AllocPause() { ++g_allocs_paused; }
+  ~AllocPause() { --g_allocs_paused; }
+  AllocPause(const AllocPause &) = delete;
+  AllocPause &operator=(const AllocPause &) = delete;
+};
+
+inline void count_alloc(std::size_t n) {
+  if (g_allocs_paused) return;
+  ++g_allocs.calls;
+  g_allocs.bytes += n;
+}
+
+} // namespace sim
+
+void *operator new(std::size_t n) {
+  sim::count_alloc(n);
+  if (void *p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void *operator new[](std::size_t n) { return ::operator new(n); }
+void *operator new(std::size_t n, const std::nothrow_t &) noexcept {
+  sim::count_alloc(n);
+  return std::malloc(n ? n : 1);
+}
+void *operator new[](std::size_t n, const std::nothrow_t &t) noexcept { return ::operator new(n, t); }
+// GCC pairs inlined new/delete calls with malloc/free and warns; they match here.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
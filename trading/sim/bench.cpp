@@ -0,0 +1,328 @@
+// ---- bench.cpp (strategy micro and macro benchmarks) --------------------------
+// Regression numbers for the strategy hot paths, in ns/op and heap
+// allocations/op:
+//
+//   book          on_orderbook_update, deltas below/above a quiet top of book
+//   snapshot      on_orderbook_snapshot with every level of both sides filled
+//   resync        on_orderbook_snapshot, 20 levels a side, alternating between
+//                 two snapshots that differ in two levels
+//   game_event    on_game_event_update with the sandbox's string arguments,
+//                 cycling through a game's events (END_GAME resets included)
+//   replay        a full game through the venue and matching engine
+//   replay_wide   the same against a market maker quoting 20 ticks a side,
+//                 where the strategy rests passive quotes and keeps or moves
+//                 them on every book change
+//
+// Micro benchmarks run against a null order sink; the replays are one game
+// per op. They also report orders, cancels and fills per game, and PnL per
+// game next to the strategy's own books for the same games (both marked at
+// settlement before the END_GAME close-out).
+//
+// --check-allocs N replays the game N times through one long-lived Strategy
+// (as the sandbox keeps one) and counts heap allocations made inside its
+// callbacks, excluding the venue's side of order calls. The first game is
+// warm-up; any allocation after it fails the run with exit status 1.
+//
+//   g++ -std=c++20 -O2 -o bench trading/sim/bench.cpp trading/sim/engine_api.cpp
+//   ./bench --file trading/Data/example-game.json [--scale 4] [--only book]
+//   ./bench --check-allocs 20
+#include "alloc_count.hpp"
+#include "replay.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Accepts everything, fills nothing.
+class NullSink final : public sim::OrderSink {
+public:
+  bool market_order(Side, float) override { return true; }
+  std::int64_t limit_order(Side, float, float, bool) override { return next_id_++; }
+  bool cancel(std::int64_t) override { return true; }
+  void log(const std::string &) override {}
+
+private:
+  std::int64_t next_id_ = 1;
+};
+
+struct Bench {
+  const char *name;
+  std::size_t ops;
+  double      ns_per_op;
+  double      allocs_per_op, bytes_per_op;
+};
+
+// Runs fn(i) for i in [0, ops) once untimed, then timed.
+template <class F>
+Bench measure(const char *name, std::size_t ops, F &&fn) {
+  for (std::size_t i = 0; i < ops; ++i) fn(i);
+  sim::AllocCount a0 = sim::allocs();
+  auto t0 = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < ops; ++i) fn(i);
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+  sim::AllocCount d = sim::allocs() - a0;
+  double n = double(ops);
+  return {name, ops, ns / n, double(d.calls) / n, double(d.bytes) / n};
+}
+
+// The quiet market the micro benchmarks trade against: lead 0 early in the
+// game puts fair value near 50.9, inside a 50.5 / 51.3 top, so no order is sent.
+constexpr float kBid = 50.5f, kAsk = 51.3f;
+
+void prime(Strategy &s) {
+  sim::g_clock = 0.0;
+  s.reset_state();
+  s.on_orderbook_snapshot(Ticker::TEAM_A, {{kBid, 100.0f}, {kBid - 0.1f, 100.0f}}, {{kAsk, 100.0f}, {kAsk + 0.1f, 100.0f}});
+  sim::g_clock = 100.0;   // past the start-up cooldown
+}
+
+Bench bench_book(std::size_t ops) {
+  struct Delta { Side side; float qty, price; };
+  std::vector<Delta> deltas(4096);
+  std::uint64_t r = 0x9E3779B97F4A7C15ull;
+  for (std::size_t i = 0; i < deltas.size(); ++i) {
+    r ^= r << 13; r ^= r >> 7; r ^= r << 17;
+    Side side = i % 2 ? Side::sell : Side::buy;
+    float depth = float(r % 20) * 0.1f;
+    float qty = (r >> 8) % 4 ? float((r >> 16) % 200 + 1) : 0.0f;   // a quarter remove the level
+    deltas[i] = {side, qty, side == Side::buy ? kBid - depth : kAsk + depth};
+  }
+  Strategy s;
+  NullSink sink;
+  sim::OrderSink::Bind bind(sink);
+  prime(s);
+  return measure("book", ops, [&](std::size_t i) {
+    const Delta &d = deltas[i % deltas.size()];
+    s.on_orderbook_update(Ticker::TEAM_A, d.side, d.qty, d.price);
+  });
+}
+
+Bench bench_snapshot(std::size_t ops) {
+  std::vector<std::pair<float, float>> bids, asks;
+  for (int t = int(kBid * 10.0f + 0.5f); t >= 0; --t) bids.push_back({float(t) * 0.1f, 10.0f + float(t % 7)});
+  for (int t = int(kAsk * 10.0f + 0.5f); t <= 1000; ++t) asks.push_back({float(t) * 0.1f, 10.0f + float(t % 5)});
+  Strategy s;
+  NullSink sink;
+  sim::OrderSink::Bind bind(sink);
+  prime(s);
+  return measure("snapshot", ops, [&](std::size_t) { s.on_orderbook_snapshot(Ticker::TEAM_A, bids, asks); });
+}
+
+Bench bench_resync(std::size_t ops) {
+  std::vector<std::pair<float, float>> snaps[2][2];
+  for (int v = 0; v < 2; ++v) {
+    for (int i = 0; i < 20; ++i) {
+      snaps[v][0].push_back({kBid - 0.1f * float(i), 50.0f + float(i)});
+      snaps[v][1].push_back({kAsk + 0.1f * float(i), 50.0f + float(i)});
+    }
+    snaps[v][0][5].second += float(v);
+    snaps[v][1][9].second += float(v);
+  }
+  Strategy s;
+  NullSink sink;
+  sim::OrderSink::Bind bind(sink);
+  prime(s);
+  return measure("resync", ops, [&](std::size_t i) {
+    const auto &snap = snaps[i % 2];
+    s.on_orderbook_snapshot(Ticker::TEAM_A, snap[0], snap[1]);
+  });
+}
+
+// Event arguments as the sandbox passes them.
+struct StringEvent {
+  std::string type, home_away;
+  int home_score, away_score;
+  std::optional<std::string> shot;
+  std::optional<double> x, y, t;
+};
+
+const char *event_name(Strategy::EventType t) {
+  static constexpr const char *kNames[] = {"UNKNOWN", "NOTHING", "START_PERIOD", "END_PERIOD", "END_GAME",
+                                           "JUMP_BALL", "SCORE", "MISSED", "REBOUND", "BLOCK", "STEAL",
+                                           "TURNOVER", "FOUL", "TIMEOUT", "SUBSTITUTION"};
+  return kNames[std::size_t(t)];
+}
+
+const char *shot_name(Strategy::ShotType s) {
+  static constexpr const char *kNames[] = {"", "FREE_THROW", "TWO_POINT", "THREE_POINT", "LAYUP", "DUNK"};
+  return kNames[std::size_t(s)];
+}
+
+Bench bench_game_event(const std::vector<Strategy::GameEvent> &events, std::size_t ops) {
+  std::vector<StringEvent> evs;
+  for (const Strategy::GameEvent &e : events) {
+    StringEvent s{event_name(e.type), e.team == Strategy::Team::HOME ? "home" : e.team == Strategy::Team::AWAY ? "away" : "unknown",
+                  e.home_score, e.away_score, std::nullopt, e.coordinate_x, e.coordinate_y, e.time_seconds};
+    if (e.shot != Strategy::ShotType::NONE) s.shot = shot_name(e.shot);
+    evs.push_back(std::move(s));
+  }
+  const std::optional<std::string> none;
+  Strategy s;
+  NullSink sink;
+  sim::OrderSink::Bind bind(sink);
+  prime(s);
+  return measure("game_event", ops, [&](std::size_t i) {
+    const StringEvent &e = evs[i % evs.size()];
+    sim::g_clock += 1.0;
+    s.on_game_event_update(e.type, e.home_away, e.home_score, e.away_score, none, none, e.shot, none, none, e.x, e.y, e.t);
+  });
+}
+
+struct GameTotals {
+  const char *name;
+  double pnl = 0.0, marked = 0.0, books = 0.0, orders = 0.0, cancels = 0.0, fills = 0.0;
+  std::size_t games = 0;
+};
+
+Bench bench_replay(const std::vector<Strategy::GameEvent> &events, const sim::MarketParams &market,
+                   std::size_t ops, GameTotals &t) {
+  return measure(t.name, ops, [&](std::size_t i) {
+    sim::ReplayResult r = sim::replay_game(events, market, 1 + i);
+    t.pnl += r.pnl;
+    t.marked += r.pnl_marked;
+    t.books += r.pnl_books;
+    t.orders += r.orders;
+    t.cancels += r.cancels;
+    t.fills += r.fills;
+    ++t.games;
+  });
+}
+
+// ───────── Allocation check ─────────
+// S with every callback the venue makes wrapped in an allocation count.
+template <class S>
+struct AllocCounted : S {
+  using S::S;
+  sim::AllocCount in_callbacks;
+
+  template <class F>
+  void counted_(F &&f) {
+    sim::AllocCount a0 = sim::allocs();
+    f();
+    sim::AllocCount d = sim::allocs() - a0;
+    in_callbacks.calls += d.calls;
+    in_callbacks.bytes += d.bytes;
+  }
+  void on_trade_update(Ticker t, Side s, float q, float p) { counted_([&] { S::on_trade_update(t, s, q, p); }); }
+  void on_orderbook_update(Ticker t, Side s, float q, float p) { counted_([&] { S::on_orderbook_update(t, s, q, p); }); }
+  void on_account_update(Ticker t, Side s, float p, float q, float c) {
+    counted_([&] { S::on_account_update(t, s, p, q, c); });
+  }
+  void on_orderbook_snapshot(Ticker t, const std::vector<std::pair<float, float>> &b,
+                             const std::vector<std::pair<float, float>> &a) {
+    counted_([&] { S::on_orderbook_snapshot(t, b, a); });
+  }
+  void on_game_event(const Strategy::GameEvent &ev) { counted_([&] { S::on_game_event(ev); }); }
+};
+
+// Forwards the strategy's orders to the venue with counting paused.
+class PausedSink final : public sim::OrderSink {
+public:
+  explicit PausedSink(sim::OrderSink &inner) : inner_(inner) {}
+  bool market_order(Side s, float q) override { sim::AllocPause p; return inner_.market_order(s, q); }
+  std::int64_t limit_order(Side s, float q, float px, bool ioc) override {
+    sim::AllocPause p;
+    return inner_.limit_order(s, q, px, ioc);
+  }
+  bool cancel(std::int64_t id) override { sim::AllocPause p; return inner_.cancel(id); }
+  void log(const std::string &text) override { sim::AllocPause p; inner_.log(text); }
+
+private:
+  sim::OrderSink &inner_;
+};
+
+// Same event loop as sim::replay_game, but the strategy outlives the game
+// and the clock keeps running across games.
+int check_allocs(const std::vector<Strategy::GameEvent> &events, int games) {
+  using S = AllocCounted<Strategy>;
+  const sim::MarketParams market;
+  auto strat = std::make_unique<S>();
+  sim::g_clock = 0.0;
+  std::uint64_t after_warmup = 0;
+  std::printf("%-6s %14s %14s\n", "game", "allocs", "bytes");
+  for (int g = 0; g < games; ++g) {
+    strat->in_callbacks = {};
+    {
+      auto venue = std::make_unique<sim::BasicVenue<S>>(*strat, market, 1 + std::uint64_t(g));
+      PausedSink sink(*venue);
+      sim::OrderSink::Bind bind(sink);
+      venue->open();
+      double prev_t = Strategy::Cfg::GAME_LEN2;
+      for (const Strategy::GameEvent &ev : events) {
+        if (ev.time_seconds) {
+          sim::g_clock += std::max(0.0, prev_t - *ev.time_seconds);
+          prev_t = *ev.time_seconds;
+        }
+        venue->on_event(ev);
+      }
+    }
+    sim::g_clock += Strategy::Cfg::INIT_COOLDOWN_SEC + 1.0;   // between games
+    std::printf("%-6d %14llu %14llu%s\n", g, (unsigned long long)strat->in_callbacks.calls,
+                (unsigned long long)strat->in_callbacks.bytes, g == 0 ? "  (warm-up)" : "");
+    if (g > 0) after_warmup += strat->in_callbacks.calls;
+  }
+  std::printf("%s: %llu allocations in strategy callbacks after warm-up\n", after_warmup ? "FAIL" : "ok",
+              (unsigned long long)after_warmup);
+  return after_warmup ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string file = "trading/Data/example-game.json", only;
+  double scale = 1.0;
+  int check_games = 0;
+  for (int i = 1; i < argc; ++i) {
+    if      (!std::strcmp(argv[i], "--file")  && i + 1 < argc) file = argv[++i];
+    else if (!std::strcmp(argv[i], "--scale") && i + 1 < argc) scale = std::max(0.01, std::atof(argv[++i]));
+    else if (!std::strcmp(argv[i], "--only")  && i + 1 < argc) only = argv[++i];
+    else if (!std::strcmp(argv[i], "--check-allocs") && i + 1 < argc) check_games = std::max(2, std::atoi(argv[++i]));
+    else {
+      std::fprintf(stderr, "usage: %s [--file F] [--scale X] [--only NAME] [--check-allocs GAMES]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  std::vector<Strategy::GameEvent> events;
+  try {
+    events = sim::load_game(file);
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  if (events.empty()) { std::fprintf(stderr, "%s: no events\n", file.c_str()); return 1; }
+  if (check_games) return check_allocs(events, check_games);
+
+  auto ops = [scale](double n) { return std::size_t(std::max(1.0, n * scale)); };
+  auto want = [&only](const char *name) { return only.empty() || only == name; };
+  std::vector<Bench> out;
+  sim::MarketParams wide;
+  wide.half_spread = 20;
+  GameTotals replays[] = {{"replay"}, {"replay_wide"}};
+  if (want("book"))       out.push_back(bench_book(ops(2e6)));
+  if (want("snapshot"))   out.push_back(bench_snapshot(ops(2e4)));
+  if (want("resync"))     out.push_back(bench_resync(ops(5e5)));
+  if (want("game_event")) out.push_back(bench_game_event(events, ops(5e5)));
+  if (want("replay"))      out.push_back(bench_replay(events, {}, ops(20), replays[0]));
+  if (want("replay_wide")) out.push_back(bench_replay(events, wide, ops(20), replays[1]));
+
+  std::printf("%-12s %10s %12s %12s %12s\n", "bench", "ops", "ns/op", "allocs/op", "bytes/op");
+  for (const Bench &b : out)
+    std::printf("%-12s %10zu %12.1f %12.3f %12.1f\n", b.name, b.ops, b.ns_per_op, b.allocs_per_op, b.bytes_per_op);
+  std::printf("replay: %zu events/game\n", events.size());
+  for (const GameTotals &t : replays) {
+    if (!t.games) continue;
+    double n = double(t.games);
+    std::printf("%s: orders/game %.1f, cancels/game %.1f, fills/game %.1f\n", t.name, t.orders / n, t.cancels / n,
+                t.fills / n);
+    std::printf("%s: pnl/game %.2f, before close-out %.2f, by strategy books %.2f\n", t.name, t.pnl / n,
+                t.marked / n, t.books / n);
+  }
+  return 0;
+}
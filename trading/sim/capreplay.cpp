@@ -0,0 +1,124 @@
+// ---- capreplay.cpp (re-drive a captured session, checking every order) -------
+// Replays the "capture" lines of a session log (from a strategy built with
+// -DKWOKKER_CAPTURE=bytes) into a fresh Strategy and checks that it sends the
+// same order calls, bit for bit, in the same places. Prints per-callback
+// latency of the replay, so sessions from the real venue can be profiled
+// offline. --record makes such a log from simulated games instead: one
+// capture-enabled strategy trades N games on the simulated venue, as the
+// sandbox keeps one strategy for a whole session.
+//
+//   g++ -std=c++20 -O2 -o capreplay trading/sim/capreplay.cpp trading/sim/engine_api.cpp
+//   ./capreplay --record trading/Data/example-game.json session.log [--games 3]
+//   ./capreplay session.log
+#include "capture.hpp"
+#include "replay.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct CaptureCfg : StrategyTypes::Cfg {
+  static constexpr int CAPTURE_BYTES = 1 << 20;
+};
+using CapturingStrategy = BasicStrategy<CaptureCfg>;
+
+// Forwards orders to the venue and writes the strategy's capture lines to a file.
+class LogTap final : public sim::OrderSink {
+public:
+  LogTap(sim::OrderSink &inner, std::FILE *out) : inner_(inner), out_(out) {}
+  bool market_order(Side s, float q) override { return inner_.market_order(s, q); }
+  std::int64_t limit_order(Side s, float q, float p, bool ioc) override { return inner_.limit_order(s, q, p, ioc); }
+  bool cancel(std::int64_t id) override { return inner_.cancel(id); }
+  void log(const std::string &text) override {
+    if (text.compare(0, 8, "capture ") == 0) { std::fprintf(out_, "%s\n", text.c_str()); ++lines; }
+    inner_.log(text);
+  }
+  std::size_t lines = 0;
+
+private:
+  sim::OrderSink &inner_;
+  std::FILE      *out_;
+};
+
+int record(const std::string &game, const std::string &out_path, int games) {
+  std::vector<Strategy::GameEvent> events = sim::load_game(game);
+  std::FILE *out = std::fopen(out_path.c_str(), "w");
+  if (!out) { std::fprintf(stderr, "cannot create %s\n", out_path.c_str()); return 1; }
+  const sim::MarketParams market;
+  sim::g_clock = 0.0;
+  std::size_t lines = 0;
+  {
+    auto strat = std::make_unique<CapturingStrategy>();
+    for (int g = 0; g < games; ++g) {
+      auto venue = std::make_unique<sim::BasicVenue<CapturingStrategy>>(*strat, market, 1 + std::uint64_t(g));
+      LogTap tap(*venue, out);
+      sim::OrderSink::Bind bind(tap);
+      venue->open();
+      double prev_t = Strategy::Cfg::GAME_LEN2;
+      for (const Strategy::GameEvent &ev : events) {
+        if (ev.time_seconds) {
+          sim::g_clock += std::max(0.0, prev_t - *ev.time_seconds);
+          prev_t = *ev.time_seconds;
+        }
+        venue->on_event(ev);
+      }
+      const sim::ReplayResult &r = venue->result();
+      std::printf("game %d: pnl %.2f  orders %u  fills %u\n", g, r.pnl, r.orders, r.fills);
+      lines += tap.lines;
+      sim::g_clock += Strategy::Cfg::INIT_COOLDOWN_SEC + 1.0;   // between games
+    }
+  }
+  bool ok = std::fclose(out) == 0;
+  std::printf("%zu capture lines -> %s\n", lines, out_path.c_str());
+  return ok ? 0 : 1;
+}
+
+int replay(const std::string &log) {
+  std::vector<std::uint8_t> bytes = sim::read_capture_log(log);
+  sim::CaptureReplayer<Strategy> replayer(bytes);
+  sim::CaptureReplayResult r = replayer.run();
+  std::printf("%s: %zu bytes, %zu records, %zu callbacks, %zu order calls\n", log.c_str(), bytes.size(), r.records,
+              r.callbacks, r.orders);
+  std::printf("%-24s %12s %10s %10s\n", "callback", "calls", "mean ns", "max ns");
+  for (std::size_t k = 0; k < std::size_t(sim::Cb::COUNT); ++k) {
+    const sim::CallbackStat &c = r.cb[k];
+    std::printf("%-24s %12llu %10.1f %10llu\n", sim::kCbNames[k], (unsigned long long)c.n, c.mean_ns(),
+                (unsigned long long)c.max_ns);
+  }
+  if (!r.ok()) {
+    std::printf("DIVERGED at %s\n", r.divergence.c_str());
+    return 1;
+  }
+  std::printf("ok: every order call matched the capture\n");
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string rec_game, path;
+  int games = 1;
+  bool usage = false;
+  for (int i = 1; i < argc; ++i) {
+    if      (!std::strcmp(argv[i], "--record") && i + 1 < argc) rec_game = argv[++i];
+    else if (!std::strcmp(argv[i], "--games")  && i + 1 < argc) games = std::max(1, std::atoi(argv[++i]));
+    else if (path.empty() && argv[i][0] != '-') path = argv[i];
+    else usage = true;
+  }
+  if (usage || path.empty()) {
+    std::fprintf(stderr, "usage: %s <session.log>\n       %s --record <game> <session.log> [--games N]\n", argv[0],
+                 argv[0]);
+    return 2;
+  }
+  try {
+    return rec_game.empty() ? replay(path) : record(rec_game, path, games);
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+}
@@ -0,0 +1,293 @@
+// ---- capture.hpp (decode and re-drive a captured strategy session) ----------
+// A strategy built with -DKWOKKER_CAPTURE=bytes prints its session as
+// "capture <seq> <base64>" lines (see StrategyTypes::Capture). This reads
+// them back out of a log, decodes the records, and replays them into a fresh
+// Strategy: inbound callbacks are delivered with their recorded arguments
+// and clock (g_clock), and each order call the strategy makes is checked bit
+// for bit against the next recorded one and answered with its recorded
+// result. Callbacks recorded before an order call's record arrived inside
+// that call and are delivered inside it again. The first mismatch stops the
+// replay and is reported.
+#pragma once
+
+#include "mapped_file.hpp"
+#include "venue.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sim {
+
+using CaptureTag = Strategy::CaptureTag;
+
+inline constexpr const char *kCaptureTagNames[] = {"start", "trade", "book", "snapshot", "account",
+                                                   "game", "market", "limit", "cancel"};
+
+// ───────── Log decoding ─────────
+// Capture bytes from every "capture" line of a session log, in sequence order.
+// Other lines, and text before "capture " on a line, are skipped. A missing
+// sequence number or a dropped-record marker means the session has a hole.
+inline std::vector<std::uint8_t> read_capture_log(const std::string &path) {
+  static constexpr std::string_view kKey = "capture ";
+  auto b64 = [](char c) -> int {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    return c == '+' ? 62 : c == '/' ? 63 : -1;
+  };
+
+  MappedFile file(path);
+  std::string_view text = file.view();
+  std::vector<std::uint8_t> out;
+  unsigned long long expect = 0;
+  while (!text.empty()) {
+    std::size_t nl = text.find('\n');
+    std::string_view line = text.substr(0, nl);
+    text.remove_prefix(nl == std::string_view::npos ? text.size() : nl + 1);
+    std::size_t at = line.find(kKey);
+    if (at == std::string_view::npos) continue;
+    line.remove_prefix(at + kKey.size());
+
+    char *end = nullptr;
+    std::string num(line.substr(0, line.find(' ')));
+    unsigned long long seq = std::strtoull(num.c_str(), &end, 10);
+    if (num.empty() || *end) continue;   // not a capture line after all
+    if (seq != expect) throw std::runtime_error(path + ": capture line " + std::to_string(expect) + " missing");
+    ++expect;
+    line.remove_prefix(std::min(line.size(), num.size() + 1));
+    if (line.substr(0, 7) == "dropped") throw std::runtime_error(path + ": the strategy dropped capture records");
+
+    while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.remove_suffix(1);
+    if (line.size() % 4) throw std::runtime_error(path + ": bad capture line " + std::to_string(seq));
+    for (std::size_t i = 0; i < line.size(); i += 4) {
+      int v[4];
+      for (int j = 0; j < 4; ++j) v[j] = line[i + j] == '=' ? 0 : b64(line[i + j]);
+      if (v[0] < 0 || v[1] < 0 || v[2] < 0 || v[3] < 0)
+        throw std::runtime_error(path + ": bad capture line " + std::to_string(seq));
+      std::uint32_t w = std::uint32_t(v[0] << 18 | v[1] << 12 | v[2] << 6 | v[3]);
+      out.push_back(std::uint8_t(w >> 16));
+      if (line[i + 2] != '=') out.push_back(std::uint8_t(w >> 8));
+      if (line[i + 3] != '=') out.push_back(std::uint8_t(w));
+    }
+  }
+  return out;
+}
+
+// ───────── Records ─────────
+struct CaptureRecord {
+  CaptureTag   tag = CaptureTag::COUNT;
+  std::uint8_t ticker = 0;
+  double       clock = 0.0;
+  Side         side = Side::buy;
+  float        qty = 0.0f, price = 0.0f, capital = 0.0f;
+  bool         ioc = false, ok = false;
+  std::int64_t id = 0;
+  Strategy::GameEvent ev;
+  std::vector<std::pair<float, float>> bids, asks;
+
+  bool inbound() const { return tag >= CaptureTag::TRADE && tag <= CaptureTag::GAME; }
+};
+
+class CaptureReader {
+public:
+  explicit CaptureReader(std::span<const std::uint8_t> bytes) : p_(bytes.data()), end_(bytes.data() + bytes.size()) {}
+
+  // Next record, reusing r's snapshot vectors. False at the end; throws on a
+  // truncated or unknown record.
+  bool next(CaptureRecord &r) {
+    if (p_ == end_) return false;
+    std::uint32_t size = 0;
+    std::uint8_t  tk[4];
+    rec_end_ = p_ + Strategy::Capture::kHeader;
+    if (std::size_t(end_ - p_) < Strategy::Capture::kHeader) fail_("truncated record");
+    get_(size);
+    get_(tk);
+    get_(r.clock);
+    if (size < Strategy::Capture::kHeader || std::size_t(end_ - p_) < size - Strategy::Capture::kHeader)
+      fail_("truncated record");
+    rec_end_ = p_ + (size - Strategy::Capture::kHeader);
+    r.tag = CaptureTag(tk[0]);
+    r.ticker = tk[1];
+
+    std::uint8_t side = 0, flag = 0;
+    switch (r.tag) {
+      case CaptureTag::START: break;
+      case CaptureTag::TRADE:
+      case CaptureTag::BOOK:    get_(side); get_(r.qty); get_(r.price); break;
+      case CaptureTag::ACCOUNT: get_(side); get_(r.price); get_(r.qty); get_(r.capital); break;
+      case CaptureTag::MARKET:  get_(side); get_(r.qty); get_(flag); r.ok = flag; break;
+      case CaptureTag::LIMIT:   get_(side); get_(r.qty); get_(r.price); get_(flag); get_(r.id); r.ioc = flag; break;
+      case CaptureTag::CANCEL:  get_(r.id); get_(flag); r.ok = flag; break;
+      case CaptureTag::SNAPSHOT: {
+        std::uint32_t nb = 0, na = 0;
+        get_(nb);
+        get_(na);
+        for (auto [side_levels, n] : {std::pair{&r.bids, nb}, std::pair{&r.asks, na}}) {
+          side_levels->resize(n);
+          for (auto &pq : *side_levels) { get_(pq.first); get_(pq.second); }
+        }
+        break;
+      }
+      case CaptureTag::GAME: {
+        std::uint8_t type, team, shot, has;
+        std::int32_t home, away;
+        double x, y, t;
+        get_(type); get_(team); get_(shot); get_(has); get_(home); get_(away); get_(x); get_(y); get_(t);
+        r.ev = {};
+        r.ev.type = Strategy::EventType(type);
+        r.ev.team = Strategy::Team(team);
+        r.ev.shot = Strategy::ShotType(shot);
+        r.ev.home_score = home;
+        r.ev.away_score = away;
+        if (has & 1) r.ev.coordinate_x = x;
+        if (has & 2) r.ev.coordinate_y = y;
+        if (has & 4) r.ev.time_seconds = t;
+        break;
+      }
+      default: fail_("unknown record tag");
+    }
+    r.side = side ? Side::sell : Side::buy;
+    if (p_ != rec_end_) fail_("record size mismatch");
+    ++count_;
+    return true;
+  }
+
+  std::size_t count() const { return count_; }
+
+private:
+  template <class T>
+  void get_(T &v) {
+    if (std::size_t(rec_end_ - p_) < sizeof v) fail_("truncated record");
+    std::memcpy(&v, p_, sizeof v);
+    p_ += sizeof v;
+  }
+  [[noreturn]] void fail_(const char *what) const {
+    throw std::runtime_error("capture record " + std::to_string(count_) + ": " + what);
+  }
+
+  const std::uint8_t *p_, *end_, *rec_end_ = nullptr;
+  std::size_t count_ = 0;
+};
+
+// ───────── Replay ─────────
+struct CaptureReplayResult {
+  std::size_t  records = 0, callbacks = 0, orders = 0;
+  std::string  divergence;            // empty if every order call matched
+  CallbackStat cb[std::size_t(Cb::COUNT)];
+
+  bool ok() const { return divergence.empty(); }
+};
+
+template <class S = Strategy>
+class CaptureReplayer final : public OrderSink {
+public:
+  explicit CaptureReplayer(std::span<const std::uint8_t> bytes) : in_(bytes) {}
+
+  CaptureReplayResult run(const typename S::Params &cfg = {}) {
+    if (!take_() || cur_.tag != CaptureTag::START) throw std::runtime_error("capture does not begin with START");
+    g_clock = cur_.clock;
+    S strat(cfg);
+    strat_ = &strat;
+    Bind bind(*this);
+    while (res_.divergence.empty() && take_()) {
+      if (cur_.inbound()) deliver_(cur_);
+      else diverge_("recorded %s was not sent", kCaptureTagNames[std::size_t(cur_.tag)]);
+    }
+    res_.records = in_.count();
+    strat_ = nullptr;
+    return res_;
+  }
+
+  // ───────── Engine API ─────────
+  bool market_order(Side side, float qty) override {
+    const CaptureRecord *r = expect_(CaptureTag::MARKET);
+    if (r && !(r->side == side && same_(r->qty, qty)))
+      r = diverge_("market %s %g, recorded %s %g", name_(side), qty, name_(r->side), r->qty);
+    return r && r->ok;
+  }
+  std::int64_t limit_order(Side side, float qty, float price, bool ioc) override {
+    const CaptureRecord *r = expect_(CaptureTag::LIMIT);
+    if (r && !(r->side == side && same_(r->qty, qty) && same_(r->price, price) && r->ioc == ioc))
+      r = diverge_("limit %s %g @ %g%s, recorded %s %g @ %g%s", name_(side), qty, price, ioc ? " ioc" : "",
+                   name_(r->side), r->qty, r->price, r->ioc ? " ioc" : "");
+    return r ? r->id : -1;
+  }
+  bool cancel(std::int64_t id) override {
+    const CaptureRecord *r = expect_(CaptureTag::CANCEL);
+    if (r && r->id != id) r = diverge_("cancel %lld, recorded cancel %lld", (long long)id, (long long)r->id);
+    return r && r->ok;
+  }
+  void log(const std::string &) override {}
+
+private:
+  static const char *name_(Side s) { return s == Side::buy ? "buy" : "sell"; }
+  static bool same_(float a, float b) { return std::memcmp(&a, &b, sizeof a) == 0; }
+
+  bool take_() {
+    if (have_next_) { std::swap(cur_, next_); have_next_ = false; return true; }
+    return in_.next(cur_);
+  }
+
+  // The record answering an order call of this tag. Callbacks recorded
+  // before it were delivered during the original call and are run now.
+  const CaptureRecord *expect_(CaptureTag tag) {
+    ++res_.orders;
+    for (;;) {
+      if (!res_.divergence.empty()) return nullptr;
+      if (!have_next_ && !(have_next_ = in_.next(next_))) return diverge_("%s sent after the capture ended", kCaptureTagNames[std::size_t(tag)]);
+      if (!next_.inbound()) break;
+      CaptureRecord nested = std::move(next_);
+      have_next_ = false;
+      deliver_(nested);
+    }
+    have_next_ = false;
+    if (next_.tag != tag)
+      return diverge_("%s sent, recorded %s", kCaptureTagNames[std::size_t(tag)], kCaptureTagNames[std::size_t(next_.tag)]);
+    return &next_;
+  }
+
+  void deliver_(const CaptureRecord &r) {
+    g_clock = r.clock;
+    ++res_.callbacks;
+    Ticker tk = Ticker(r.ticker);
+    auto t0 = std::chrono::steady_clock::now();
+    Cb kind = Cb::COUNT;
+    switch (r.tag) {
+      case CaptureTag::TRADE:    kind = Cb::TRADE;    strat_->on_trade_update(tk, r.side, r.qty, r.price); break;
+      case CaptureTag::BOOK:     kind = Cb::BOOK;     strat_->on_orderbook_update(tk, r.side, r.qty, r.price); break;
+      case CaptureTag::SNAPSHOT: kind = Cb::SNAPSHOT; strat_->on_orderbook_snapshot(tk, r.bids, r.asks); break;
+      case CaptureTag::ACCOUNT:  kind = Cb::ACCOUNT;  strat_->on_account_update(tk, r.side, r.price, r.qty, r.capital); break;
+      case CaptureTag::GAME:     kind = Cb::GAME;     strat_->on_game_event(r.ev, tk); break;
+      default: break;
+    }
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    if (kind != Cb::COUNT) res_.cb[std::size_t(kind)].add(std::uint64_t(ns));
+  }
+
+  template <class... A>
+  const CaptureRecord *diverge_(const char *fmt, A... args) {
+    if (res_.divergence.empty()) {
+      char text[256];
+      std::snprintf(text, sizeof text, fmt, args...);
+      res_.divergence = "record " + std::to_string(in_.count()) + ": " + text;
+    }
+    return nullptr;
+  }
+
+  CaptureReader       in_;
+  CaptureRecord       cur_, next_;
+  bool                have_next_ = false;
+  S                  *strat_ = nullptr;
+  CaptureReplayResult res_;
+};
+
+} // namespace sim
@@ -0,0 +1,235 @@
+// ---- columns.hpp (research CSVs as mapped float columns) ---------------------
+// Loads the notebooks' data files (research/data/train.csv: time, A..N, Y1,
+// Y2; test.csv: id, time, A..N; *_new.csv: O, P) as named float columns.
+// The first load parses the CSV and writes a column cache next to it:
+//
+//   Header (64 B) | name x cols (32 B each) | column x cols (rows floats,
+//   each padded to 64 B)
+//
+// Later loads map the cache and hand out spans straight into the mapping, so
+// they cost a page fault per touched page instead of a parse. The cache is
+// used only while the CSV's size and mtime match the ones recorded in it;
+// otherwise it is rebuilt. Empty fields read as NaN. Values are floats, the
+// precision the strategy and the batch kernels compute in.
+#pragma once
+
+#include "mapped_file.hpp"
+
+#include <sys/stat.h>
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sim {
+
+inline constexpr char     kColMagic[8] = {'Q', 'C', 'C', 'O', 'L', 'S', '0', '1'};
+inline constexpr uint32_t kColVersion  = 2;   // 2: partly numeric fields are rejected, so v1 caches are rebuilt
+inline constexpr std::size_t kColNameLen = 32;
+inline constexpr std::size_t kColAlign   = 64;
+
+struct ColHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t cols;
+  uint64_t rows;
+  uint64_t src_size;       // CSV the cache was built from
+  int64_t  src_mtime_ns;
+  char     reserved[24];
+};
+static_assert(sizeof(ColHeader) == 64);
+
+class ColumnTable {
+public:
+  // Cache path for a CSV: the same path with ".cols" appended.
+  static std::string cache_path(const std::string &csv) { return csv + ".cols"; }
+
+  // Columns of `csv`, from its cache when that is current. A stale or missing
+  // cache is rebuilt; if it cannot be written the parsed columns are kept in
+  // memory instead. `rebuild` ignores any existing cache.
+  static ColumnTable load(const std::string &csv, bool rebuild = false) {
+    SourceStamp src = stamp_(csv);
+    std::string cache = cache_path(csv);
+    if (!rebuild) {
+      try {
+        ColumnTable t = map_(cache);
+        if (t.h_.src_size == src.size && t.h_.src_mtime_ns == src.mtime_ns) return t;
+      } catch (const std::exception &) {
+        // missing or unreadable: rebuild below
+      }
+    }
+    ColumnTable parsed = parse_(csv);
+    parsed.h_.src_size = src.size;
+    parsed.h_.src_mtime_ns = src.mtime_ns;
+    if (parsed.write_(cache)) return map_(cache);
+    return parsed;
+  }
+
+  // Spans and names point into this object's storage: move it, never copy.
+  ColumnTable(ColumnTable &&) = default;
+  ColumnTable &operator=(ColumnTable &&) = default;
+  ColumnTable(const ColumnTable &) = delete;
+  ColumnTable &operator=(const ColumnTable &) = delete;
+
+  std::size_t rows() const { return std::size_t(h_.rows); }
+  std::size_t cols() const { return names_.size(); }
+  const std::vector<std::string_view> &names() const { return names_; }
+  bool from_cache() const { return file_ != nullptr; }
+
+  bool has(std::string_view name) const { return index_(name) < names_.size(); }
+  std::span<const float> column(std::string_view name) const {
+    std::size_t i = index_(name);
+    if (i >= names_.size()) throw std::runtime_error("no column " + std::string(name));
+    return columns_[i];
+  }
+  std::span<const float> column(std::size_t i) const { return columns_.at(i); }
+
+private:
+  ColumnTable() = default;
+
+  struct SourceStamp {
+    uint64_t size;
+    int64_t  mtime_ns;
+  };
+
+  static SourceStamp stamp_(const std::string &path) {
+    struct stat st {};
+    if (::stat(path.c_str(), &st) != 0) throw std::runtime_error("cannot stat " + path);
+    return {uint64_t(st.st_size), int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec};
+  }
+
+  static std::size_t padded_(std::size_t bytes) { return (bytes + kColAlign - 1) / kColAlign * kColAlign; }
+
+  std::size_t index_(std::string_view name) const {
+    std::size_t i = 0;
+    while (i < names_.size() && names_[i] != name) ++i;
+    return i;
+  }
+
+  // ───────── CSV ─────────
+  static ColumnTable parse_(const std::string &csv) {
+    MappedFile file(csv);
+    std::string_view text = file.view();
+    auto next_line = [&text]() {
+      std::size_t nl = text.find('\n');
+      std::string_view line = text.substr(0, nl);
+      text.remove_prefix(nl == std::string_view::npos ? text.size() : nl + 1);
+      if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+      return line;
+    };
+
+    ColumnTable t;
+    std::string_view header = next_line();
+    if (header.empty()) throw std::runtime_error(csv + ": no header");
+    for (std::size_t b = 0;;) {
+      std::size_t e = header.find(',', b);
+      std::string_view name = header.substr(b, e == std::string_view::npos ? e : e - b);
+      if (name.empty() || name.size() >= kColNameLen) throw std::runtime_error(csv + ": bad column name");
+      t.name_store_.emplace_back(name);
+      if (e == std::string_view::npos) break;
+      b = e + 1;
+    }
+
+    const std::size_t cols = t.name_store_.size();
+    t.owned_.resize(cols);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    for (std::size_t row = 1; !text.empty(); ++row) {
+      std::string_view line = next_line();
+      if (line.empty()) continue;
+      const char *p = line.data(), *end = line.data() + line.size();
+      for (std::size_t c = 0; c < cols; ++c) {
+        const char *f = p;
+        while (p < end && *p != ',') ++p;
+        float v = nan;
+        if (p != f) {
+          std::from_chars_result res = std::from_chars(f, p, v);
+          if (res.ec != std::errc{} || res.ptr != p)   // "2x" parses as 2 otherwise
+            throw std::runtime_error(csv + ": bad number on line " + std::to_string(row + 1));
+        }
+        t.owned_[c].push_back(v);
+        if (c + 1 < cols) {
+          if (p == end) throw std::runtime_error(csv + ": short line " + std::to_string(row + 1));
+          ++p;
+        }
+      }
+      if (p != end) throw std::runtime_error(csv + ": long line " + std::to_string(row + 1));
+    }
+
+    std::memcpy(t.h_.magic, kColMagic, sizeof t.h_.magic);
+    t.h_.version = kColVersion;
+    t.h_.cols = uint32_t(cols);
+    t.h_.rows = t.owned_.empty() ? 0 : t.owned_[0].size();
+    for (const std::string &n : t.name_store_) t.names_.push_back(n);
+    for (const std::vector<float> &c : t.owned_) t.columns_.push_back(c);
+    return t;
+  }
+
+  // ───────── Cache ─────────
+  // Written to a temporary name and renamed, so readers never map a partial file.
+  bool write_(const std::string &path) const {
+    std::string tmp = path + ".tmp";
+    std::FILE *f = std::fopen(tmp.c_str(), "wb");
+    if (!f) return false;
+    static constexpr char kZeros[kColAlign] = {};
+    std::size_t used = sizeof h_;
+    bool ok = std::fwrite(&h_, sizeof h_, 1, f) == 1;
+    for (std::string_view n : names_) {
+      char name[kColNameLen] = {};
+      std::memcpy(name, n.data(), n.size());
+      ok = ok && std::fwrite(name, sizeof name, 1, f) == 1;
+      used += sizeof name;
+    }
+    for (std::span<const float> c : columns_) {
+      ok = ok && std::fwrite(kZeros, 1, padded_(used) - used, f) == padded_(used) - used;
+      used = padded_(used);
+      if (!c.empty()) ok = ok && std::fwrite(c.data(), sizeof(float), c.size(), f) == c.size();
+      used += c.size_bytes();
+    }
+    ok = (std::fclose(f) == 0) && ok;
+    if (ok && std::rename(tmp.c_str(), path.c_str()) == 0) return true;
+    std::remove(tmp.c_str());
+    return false;
+  }
+
+  static ColumnTable map_(const std::string &path) {
+    ColumnTable t;
+    t.file_ = std::make_unique<MappedFile>(path);
+    const MappedFile &file = *t.file_;
+    if (file.size() < sizeof(ColHeader)) throw std::runtime_error(path + ": not a column cache");
+    std::memcpy(&t.h_, file.data(), sizeof t.h_);
+    if (std::memcmp(t.h_.magic, kColMagic, sizeof t.h_.magic) != 0 || t.h_.version != kColVersion)
+      throw std::runtime_error(path + ": bad column cache header");
+
+    std::size_t at = sizeof(ColHeader) + std::size_t(t.h_.cols) * kColNameLen;
+    if (file.size() < at) throw std::runtime_error(path + ": truncated column cache");
+    for (uint32_t c = 0; c < t.h_.cols; ++c) {
+      const char *n = file.data() + sizeof(ColHeader) + c * kColNameLen;
+      t.names_.push_back(std::string_view(n, strnlen(n, kColNameLen)));
+    }
+    for (uint32_t c = 0; c < t.h_.cols; ++c) {
+      at = padded_(at);
+      if (file.size() < at + t.h_.rows * sizeof(float)) throw std::runtime_error(path + ": truncated column cache");
+      t.columns_.push_back({reinterpret_cast<const float *>(file.data() + at), std::size_t(t.h_.rows)});
+      at += t.h_.rows * sizeof(float);
+    }
+    return t;
+  }
+
+  ColHeader h_{};
+  std::vector<std::string_view>       names_;
+  std::vector<std::span<const float>> columns_;
+  std::unique_ptr<MappedFile>         file_;         // cache mapping, or null
+  std::vector<std::string>            name_store_;   // parsed, when not mapped
+  std::vector<std::vector<float>>     owned_;
+};
+
+} // namespace sim
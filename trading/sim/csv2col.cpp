@@ -0,0 +1,115 @@
+// ---- csv2col.cpp (research CSV -> cached float columns) ----------------------
+// Builds (or refreshes) the column cache of each CSV and prints its shape, the
+// load time and per-column count, NaNs, mean and range. A second run shows
+// the cached load time.
+//
+// --check DIR loads a set of small CSVs written into DIR and fails (exit
+// status 1) unless each parses or is rejected as expected: partly numeric
+// fields such as "12abc" are errors, empty fields are NaN, blank lines are
+// skipped, and the cached load returns what the parse did.
+//
+//   g++ -std=c++20 -O2 -o csv2col trading/sim/csv2col.cpp
+//   ./csv2col research/data/train.csv research/data/test.csv [--rebuild]
+//   ./csv2col --check /tmp
+#include "columns.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Case {
+  const char *name, *text;
+  bool        ok;               // expected to load
+  float       b1;               // column b, row 1, when it loads (NaN: missing)
+  std::size_t rows;
+};
+
+constexpr Case kCases[] = {
+    {"plain",      "a,b\n1,2.5\n3,4\n",        true,  4.0f, 2},
+    {"empty",      "a,b\n1,\n3,\n",             true,  NAN,  2},
+    {"blank_line", "a,b\n1,2\n\n3,4\r\n",       true,  4.0f, 2},
+    {"trailing",   "a,b\n1,2\n3,12abc\n",       false, 0.0f, 0},
+    {"suffix",     "a,b\n1.5abc,2\n",           false, 0.0f, 0},
+    {"short",      "a,b\n1\n",                  false, 0.0f, 0},
+    {"long",       "a,b\n1,2,3\n",              false, 0.0f, 0},
+};
+
+bool same(float x, float y) { return std::isnan(x) ? std::isnan(y) : x == y; }
+
+int check(const std::string &dir) {
+  int failed = 0;
+  for (const Case &c : kCases) {
+    std::string path = dir + "/csv2col_check_" + c.name + ".csv";
+    std::FILE *f = std::fopen(path.c_str(), "w");
+    if (!f || std::fputs(c.text, f) < 0 || std::fclose(f) != 0) {
+      std::fprintf(stderr, "cannot write %s\n", path.c_str());
+      return 1;
+    }
+    std::string got = "ok";
+    for (bool cached : {false, true}) {   // the parse, then the cache it wrote
+      try {
+        sim::ColumnTable t = sim::ColumnTable::load(path, /*rebuild=*/!cached);
+        if (!c.ok) got = "loaded";
+        else if (t.rows() != c.rows || !same(t.column("b")[1], c.b1)) got = "wrong values";
+      } catch (const std::exception &e) {
+        if (c.ok) got = e.what();
+      }
+    }
+    std::printf("%-12s %s\n", c.name, got.c_str());
+    failed += got != "ok";
+    std::remove(path.c_str());
+    std::remove(sim::ColumnTable::cache_path(path).c_str());
+  }
+  if (failed) std::printf("FAILED: %d cases\n", failed);
+  return failed ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<std::string> files;
+  std::string check_dir;
+  bool rebuild = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--rebuild")) rebuild = true;
+    else if (!std::strcmp(argv[i], "--check") && i + 1 < argc) check_dir = argv[++i];
+    else files.push_back(argv[i]);
+  }
+  if (!check_dir.empty()) return check(check_dir);
+  if (files.empty()) {
+    std::fprintf(stderr, "usage: %s <data.csv>... [--rebuild]\n       %s --check DIR\n", argv[0], argv[0]);
+    return 2;
+  }
+
+  for (const std::string &path : files) {
+    try {
+      auto t0 = std::chrono::steady_clock::now();
+      sim::ColumnTable t = sim::ColumnTable::load(path, rebuild);
+      double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+      std::printf("%s: %zu rows x %zu cols, %s in %.2f ms\n", path.c_str(), t.rows(), t.cols(),
+                  t.from_cache() ? "mapped cache" : "parsed (cache not writable)", ms);
+      std::printf("  %-8s %8s %8s %12s %12s %12s\n", "column", "values", "nan", "mean", "min", "max");
+      for (std::size_t c = 0; c < t.cols(); ++c) {
+        std::size_t n = 0, nan = 0;
+        double sum = 0.0, lo = INFINITY, hi = -INFINITY;
+        for (float v : t.column(c)) {
+          if (std::isnan(v)) { ++nan; continue; }
+          ++n; sum += v; lo = std::min(lo, double(v)); hi = std::max(hi, double(v));
+        }
+        std::printf("  %-8.*s %8zu %8zu %12.4f %12.4f %12.4f\n", int(t.names()[c].size()), t.names()[c].data(), n, nan,
+                    n ? sum / double(n) : NAN, n ? lo : NAN, n ? hi : NAN);
+      }
+    } catch (const std::exception &e) {
+      std::fprintf(stderr, "%s\n", e.what());
+      return 1;
+    }
+  }
+  return 0;
+}
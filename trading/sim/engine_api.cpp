@@ -0,0 +1,22 @@
+// ---- engine_api.cpp (free engine functions -> current sim::OrderSink) ---------
+// Link into any native tool that drives a strategy through sim::BasicVenue.
+#include "venue.hpp"
+
+bool place_market_order(Side side, Ticker /*ticker*/, float quantity) {
+  sim::OrderSink *v = sim::OrderSink::current();
+  return v && v->market_order(side, quantity);
+}
+
+std::int64_t place_limit_order(Side side, Ticker /*ticker*/, float quantity, float price, bool ioc) {
+  sim::OrderSink *v = sim::OrderSink::current();
+  return v ? v->limit_order(side, quantity, price, ioc) : -1;
+}
+
+bool cancel_order(Ticker /*ticker*/, std::int64_t order_id) {
+  sim::OrderSink *v = sim::OrderSink::current();
+  return v && v->cancel(order_id);
+}
+
+void println(const std::string &text) {
+  if (sim::OrderSink *v = sim::OrderSink::current()) v->log(text);
+}
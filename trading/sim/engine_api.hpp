@@ -0,0 +1,17 @@
+// ---- engine_api.hpp (native stand-in for the sandbox API) ---------------------
+// Same declarations as Data/template.hpp, minus its placeholder Strategy, so
+// kwokker_algo.hpp can be compiled and driven offline. Keep the two in sync.
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+enum class Side { buy = 0, sell = 1 };
+enum class Ticker : std::uint8_t { TEAM_A = 0 }; // NOLINT
+
+bool place_market_order(Side side, Ticker ticker, float quantity);
+std::int64_t place_limit_order(Side side, Ticker ticker, float quantity,
+                               float price, bool ioc = false);
+bool cancel_order(Ticker ticker, std::int64_t order_id);
+void println(const std::string &text);
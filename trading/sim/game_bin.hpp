@@ -0,0 +1,189 @@
+// ---- game_bin.hpp (packed binary game-event log) ------------------------------
+// Fixed-stride event records for fast replays and parameter sweeps:
+//
+//   Header (32 B) | EventRecord x count (24 B each) | name table
+//
+// The name table interns player names: u16 length + bytes, one per id,
+// id 0 meaning "no player". Files are little-endian and mapped read-only.
+// time_seconds is kept as the double the JSON parse gave, so a .bin replay
+// matches the JSON one exactly; coordinates are quantized (the strategy
+// does not trade on them).
+#pragma once
+
+#include "game_json.hpp"
+#include "mapped_file.hpp"
+#include "strategy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace sim {
+
+inline constexpr char     kBinMagic[8] = {'Q', 'C', 'G', 'A', 'M', 'E', '0', '1'};
+inline constexpr uint32_t kBinVersion  = 2;       // 2: double time_seconds (v1: float)
+inline constexpr float    kCoordScale  = 16.0f;   // coordinates stored in 1/16 ft
+
+struct BinHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t record_size;
+  uint64_t count;
+  uint32_t names;          // interned player names, excluding id 0
+  uint32_t reserved;
+};
+static_assert(sizeof(BinHeader) == 32);
+
+struct EventRecord {
+  enum Flags : uint8_t {
+    HAS_TIME = 1, HAS_X = 2, HAS_Y = 4,
+    REB_OFFENSIVE = 8, REB_DEFENSIVE = 16,
+  };
+  uint8_t  type;           // Strategy::EventType
+  uint8_t  team;           // Strategy::Team
+  uint8_t  shot;           // Strategy::ShotType
+  uint8_t  flags;
+  uint16_t home_score, away_score;
+  double   time_seconds;
+  int16_t  x_q, y_q;       // coordinate * kCoordScale
+  uint16_t player;         // player_name id
+  uint16_t player2;        // substituted_player_name on SUBSTITUTION, else assist_player
+};
+static_assert(sizeof(EventRecord) == 24);
+
+inline Strategy::GameEvent to_event(const EventRecord &r) {
+  Strategy::GameEvent ev;
+  ev.type = Strategy::EventType(r.type);
+  ev.team = Strategy::Team(r.team);
+  ev.shot = Strategy::ShotType(r.shot);
+  ev.home_score = r.home_score;
+  ev.away_score = r.away_score;
+  if (r.flags & EventRecord::HAS_TIME) ev.time_seconds = r.time_seconds;
+  if (r.flags & EventRecord::HAS_X)    ev.coordinate_x = r.x_q / kCoordScale;
+  if (r.flags & EventRecord::HAS_Y)    ev.coordinate_y = r.y_q / kCoordScale;
+  return ev;
+}
+inline const Strategy::GameEvent &to_event(const Strategy::GameEvent &ev) { return ev; }
+
+// ───────── Writer ─────────
+class BinWriter {
+public:
+  void add(const RawEvent &raw) {
+    const Strategy::GameEvent &ev = raw.ev;
+    EventRecord r{};
+    r.type = uint8_t(ev.type);
+    r.team = uint8_t(ev.team);
+    r.shot = uint8_t(ev.shot);
+    r.home_score = uint16_t(ev.home_score);
+    r.away_score = uint16_t(ev.away_score);
+    if (ev.time_seconds) { r.flags |= EventRecord::HAS_TIME; r.time_seconds = *ev.time_seconds; }
+    if (ev.coordinate_x) { r.flags |= EventRecord::HAS_X; r.x_q = quantize_(*ev.coordinate_x); }
+    if (ev.coordinate_y) { r.flags |= EventRecord::HAS_Y; r.y_q = quantize_(*ev.coordinate_y); }
+    if (!raw.rebound_type.empty())
+      r.flags |= raw.rebound_type[0] == 'O' ? EventRecord::REB_OFFENSIVE : EventRecord::REB_DEFENSIVE;
+    r.player  = intern_(raw.player_name);
+    r.player2 = intern_(ev.type == Strategy::EventType::SUBSTITUTION ? raw.substituted_player_name : raw.assist_player);
+    records_.push_back(r);
+  }
+
+  void write(const std::string &path) const {
+    std::FILE *f = std::fopen(path.c_str(), "wb");
+    if (!f) throw std::runtime_error("cannot create " + path);
+    BinHeader h{};
+    std::memcpy(h.magic, kBinMagic, sizeof h.magic);
+    h.version = kBinVersion;
+    h.record_size = sizeof(EventRecord);
+    h.count = records_.size();
+    h.names = uint32_t(names_.size());
+    bool ok = std::fwrite(&h, sizeof h, 1, f) == 1;
+    if (!records_.empty()) ok = ok && std::fwrite(records_.data(), sizeof(EventRecord), records_.size(), f) == records_.size();
+    for (const std::string &n : names_) {
+      uint16_t len = uint16_t(n.size());
+      ok = ok && std::fwrite(&len, sizeof len, 1, f) == 1 && std::fwrite(n.data(), 1, n.size(), f) == n.size();
+    }
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) throw std::runtime_error("short write to " + path);
+  }
+
+  std::size_t size() const { return records_.size(); }
+
+private:
+  static int16_t quantize_(double v) {
+    return int16_t(std::clamp(std::lround(v * kCoordScale), long(INT16_MIN), long(INT16_MAX)));
+  }
+  uint16_t intern_(std::string_view name) {
+    if (name.empty()) return 0;
+    auto it = ids_.find(std::string(name));
+    if (it != ids_.end()) return it->second;
+    if (names_.size() >= UINT16_MAX) throw std::runtime_error("too many player names");
+    names_.emplace_back(name);
+    uint16_t id = uint16_t(names_.size());
+    ids_.emplace(names_.back(), id);
+    return id;
+  }
+
+  std::vector<EventRecord> records_;
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, uint16_t> ids_;
+};
+
+// ───────── Reader ─────────
+class BinGame {
+public:
+  explicit BinGame(const std::string &path) : file_(path) {
+    if (file_.size() < sizeof(BinHeader)) throw std::runtime_error(path + ": not a game log");
+    std::memcpy(&h_, file_.data(), sizeof h_);
+    // count is checked by division: a corrupt count times the record size can wrap.
+    if (std::memcmp(h_.magic, kBinMagic, sizeof h_.magic) != 0 || h_.version != kBinVersion ||
+        h_.record_size != sizeof(EventRecord) ||
+        h_.count > (file_.size() - sizeof(BinHeader)) / sizeof(EventRecord))
+      throw std::runtime_error(path + ": bad game log header");
+    records_ = {reinterpret_cast<const EventRecord *>(file_.data() + sizeof(BinHeader)), std::size_t(h_.count)};
+
+    std::string_view tail = file_.view().substr(sizeof(BinHeader) + h_.count * sizeof(EventRecord));
+    names_.reserve(h_.names);
+    for (uint32_t i = 0; i < h_.names; ++i) {
+      uint16_t len = 0;
+      if (tail.size() < sizeof len) throw std::runtime_error(path + ": truncated name table");
+      std::memcpy(&len, tail.data(), sizeof len);
+      if (tail.size() < sizeof len + len) throw std::runtime_error(path + ": truncated name table");
+      names_.push_back(tail.substr(sizeof len, len));
+      tail.remove_prefix(sizeof len + len);
+    }
+  }
+
+  static bool is_bin(std::string_view data) {
+    return data.size() >= sizeof kBinMagic && std::memcmp(data.data(), kBinMagic, sizeof kBinMagic) == 0;
+  }
+
+  std::span<const EventRecord> records() const { return records_; }
+  std::string_view name(uint16_t id) const { return id == 0 || id > names_.size() ? std::string_view{} : names_[id - 1]; }
+
+private:
+  MappedFile file_;
+  BinHeader h_{};
+  std::span<const EventRecord> records_;
+  std::vector<std::string_view> names_;
+};
+
+// Load either format, chosen by the file's magic bytes.
+inline std::vector<Strategy::GameEvent> load_game(const std::string &path) {
+  bool bin = false;
+  { MappedFile probe(path); bin = BinGame::is_bin(probe.view()); }
+  if (!bin) return load_game_json(path);
+  BinGame game(path);
+  std::vector<Strategy::GameEvent> out;
+  out.reserve(game.records().size());
+  for (const EventRecord &r : game.records()) out.push_back(to_event(r));
+  return out;
+}
+
+} // namespace sim
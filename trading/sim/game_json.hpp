@@ -0,0 +1,133 @@
+// ---- game_json.hpp (streaming reader for example-game.json) -------------------
+// Pull-style reader over the flat event array used by Data/example-game.json.
+// Each next() decodes one object in place: enums are classified, numbers are
+// parsed with from_chars and string fields are views into the source buffer
+// (normally a MappedFile), so reading a game allocates nothing.
+#pragma once
+
+#include "mapped_file.hpp"
+#include "strategy.hpp"
+
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sim {
+
+struct RawEvent {
+  Strategy::GameEvent ev;
+  // Empty when null in the source. Views into the reader's buffer.
+  std::string_view player_name, substituted_player_name, assist_player, rebound_type;
+};
+
+class GameEventReader {
+public:
+  explicit GameEventReader(std::string_view json) : p_(json.data()), end_(json.data() + json.size()) {
+    ws_();
+    if (p_ < end_ && *p_ == '[') ++p_;
+    else fail_("expected '['");
+  }
+
+  // Decode the next event into out. Returns false at the end of the array.
+  bool next(RawEvent &out) {
+    ws_();
+    if (p_ < end_ && *p_ == ',') { ++p_; ws_(); }
+    if (p_ >= end_ || *p_ == ']') return false;
+    if (*p_ != '{') fail_("expected '{'");
+    ++p_;
+
+    out = RawEvent{};
+    for (;;) {
+      ws_();
+      if (p_ < end_ && *p_ == '}') { ++p_; return true; }
+      if (p_ < end_ && *p_ == ',') { ++p_; ws_(); }
+      std::string_view key = string_();
+      ws_();
+      if (p_ >= end_ || *p_ != ':') fail_("expected ':'");
+      ++p_;
+      ws_();
+      field_(out, key);
+    }
+  }
+
+private:
+  enum class Val : std::uint8_t { NUL, STR, NUM, OTHER };
+
+  void ws_() { while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_; }
+
+  [[noreturn]] void fail_(const char *what) const { throw std::runtime_error(std::string("game json: ") + what); }
+
+  std::string_view string_() {
+    if (p_ >= end_ || *p_ != '"') fail_("expected string");
+    const char *b = ++p_;
+    while (p_ < end_ && *p_ != '"') p_ += (*p_ == '\\') ? 2 : 1;
+    if (p_ >= end_) fail_("unterminated string");
+    return {b, std::size_t(p_++ - b)};
+  }
+
+  // Scan one scalar value; sets sv to its text (unquoted for strings).
+  Val value_(std::string_view &sv) {
+    if (p_ < end_ && *p_ == '"') { sv = string_(); return Val::STR; }
+    const char *b = p_;
+    while (p_ < end_ && *p_ != ',' && *p_ != '}' && *p_ != ' ' && *p_ != '\n' && *p_ != '\r') ++p_;
+    sv = {b, std::size_t(p_ - b)};
+    if (sv == "null") return Val::NUL;
+    return sv.empty() ? Val::OTHER : Val::NUM;
+  }
+
+  static std::optional<double> num_(Val k, std::string_view sv) {
+    double d = 0.0;
+    if (k != Val::NUM || std::from_chars(sv.data(), sv.data() + sv.size(), d).ec != std::errc{}) return std::nullopt;
+    return d;
+  }
+
+  void field_(RawEvent &out, std::string_view key) {
+    std::string_view sv;
+    Val k = value_(sv);
+    std::string_view str = k == Val::STR ? sv : std::string_view{};
+    Strategy::GameEvent &ev = out.ev;
+
+    // Keys dispatch on (first char, length) like the event classifiers.
+    switch (key.empty() ? 0 : key[0]) {
+      case 'e': ev.type = Strategy::classify_event(str); break;                    // event_type
+      case 'h':
+        if (key.size() == 9) ev.team = Strategy::classify_team(str);              // home_away
+        else ev.home_score = int(num_(k, sv).value_or(0.0));                       // home_score
+        break;
+      case 'a':
+        if (key.size() == 10) ev.away_score = int(num_(k, sv).value_or(0.0));     // away_score
+        else out.assist_player = str;                                              // assist_player
+        break;
+      case 's':
+        if (key.size() == 9) ev.shot = Strategy::classify_shot(str);              // shot_type
+        else out.substituted_player_name = str;                                    // substituted_player_name
+        break;
+      case 'p': out.player_name = str; break;                                      // player_name
+      case 'r': out.rebound_type = str; break;                                     // rebound_type
+      case 'c':
+        if (key.back() == 'x') ev.coordinate_x = num_(k, sv);                      // coordinate_x
+        else ev.coordinate_y = num_(k, sv);                                        // coordinate_y
+        break;
+      case 't': ev.time_seconds = num_(k, sv); break;                             // time_seconds
+      default: break;
+    }
+  }
+
+  const char *p_;
+  const char *end_;
+};
+
+// Convenience: map a game file and decode every event.
+inline std::vector<Strategy::GameEvent> load_game_json(const std::string &path) {
+  MappedFile file(path);
+  GameEventReader reader(file.view());
+  std::vector<Strategy::GameEvent> out;
+  out.reserve(file.size() / 300);   // ~330 bytes per pretty-printed event
+  RawEvent raw;
+  while (reader.next(raw)) out.push_back(raw.ev);
+  return out;
+}
+
+} // namespace sim
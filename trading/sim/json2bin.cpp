@@ -0,0 +1,122 @@
+// ---- json2bin.cpp (game JSON -> packed binary event log) ----------------------
+//
+// --check DIR converts the game into DIR, then fails (exit status 1) unless
+// the .bin events match the JSON ones (times exactly, coordinates to the
+// quantum) and replays of both give identical results over --games seeds.
+// It also round-trips a few fractional times, which a float field lost.
+//
+//   g++ -std=c++20 -O2 -o json2bin trading/sim/json2bin.cpp trading/sim/engine_api.cpp
+//   ./json2bin trading/Data/example-game.json example-game.bin
+//   ./json2bin --check /tmp [--file trading/Data/example-game.json] [--games 20]
+#include "game_bin.hpp"
+#include "replay.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool same_event(const Strategy::GameEvent &a, const Strategy::GameEvent &b) {
+  auto near = [](const std::optional<double> &x, const std::optional<double> &y) {
+    return x.has_value() == y.has_value() && (!x || std::fabs(*x - *y) <= 0.5 / sim::kCoordScale);
+  };
+  return a.type == b.type && a.team == b.team && a.shot == b.shot && a.home_score == b.home_score &&
+         a.away_score == b.away_score && a.time_seconds == b.time_seconds && near(a.coordinate_x, b.coordinate_x) &&
+         near(a.coordinate_y, b.coordinate_y);
+}
+
+bool same_result(const sim::ReplayResult &a, const sim::ReplayResult &b) {
+  return a.pnl == b.pnl && a.pnl_marked == b.pnl_marked && a.pnl_books == b.pnl_books && a.volume == b.volume &&
+         a.orders == b.orders && a.cancels == b.cancels && a.fills == b.fills;
+}
+
+void convert(const std::string &in_path, const std::string &out_path, std::size_t *count = nullptr) {
+  sim::MappedFile in(in_path);
+  sim::GameEventReader reader(in.view());
+  sim::BinWriter out;
+  sim::RawEvent raw;
+  while (reader.next(raw)) out.add(raw);
+  out.write(out_path);
+  if (count) *count = out.size();
+}
+
+int check(const std::string &dir, const std::string &file, int games) {
+  int failed = 0;
+  auto report = [&](const char *name, const std::string &got) {
+    std::printf("%-12s %s\n", name, got.c_str());
+    failed += got != "ok";
+  };
+
+  std::string bin = dir + "/json2bin_check.bin";
+  try {
+    convert(file, bin);
+    std::vector<Strategy::GameEvent> js = sim::load_game(file), bs = sim::load_game(bin);
+    std::string got = js.size() == bs.size() ? "ok" : "event count differs";
+    for (std::size_t i = 0; got == "ok" && i < js.size(); ++i)
+      if (!same_event(js[i], bs[i])) got = "event " + std::to_string(i) + " differs";
+    report("events", got);
+
+    sim::MarketParams wide;
+    wide.half_spread = 20;
+    got = "ok";
+    for (const sim::MarketParams &params : {sim::MarketParams{}, wide})
+      for (int g = 0; got == "ok" && g < games; ++g)
+        if (!same_result(sim::replay_game(js, params, 1 + std::uint64_t(g)),
+                         sim::replay_game(bs, params, 1 + std::uint64_t(g))))
+          got = "seed " + std::to_string(1 + g) + " at half spread " + std::to_string(params.half_spread) + " differs";
+    report("replays", got);
+
+    // Times a float record rounded: 0.1 and 1234.567 are not floats.
+    sim::BinWriter w;
+    sim::RawEvent raw;
+    const double times[] = {2879.9, 1234.567, 0.1};
+    for (double t : times) { raw.ev.time_seconds = t; w.add(raw); }
+    w.write(bin);
+    sim::BinGame g(bin);
+    got = "ok";
+    for (std::size_t i = 0; i < std::size(times); ++i)
+      if (sim::to_event(g.records()[i]).time_seconds != times[i]) got = "time " + std::to_string(times[i]) + " changed";
+    report("frac_times", got);
+  } catch (const std::exception &e) {
+    report("error", e.what());
+  }
+  std::remove(bin.c_str());
+  if (failed) std::printf("FAILED: %d checks\n", failed);
+  return failed ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<std::string> paths;
+  std::string check_dir, file = "trading/Data/example-game.json";
+  int games = 20;
+  for (int i = 1; i < argc; ++i) {
+    if      (!std::strcmp(argv[i], "--check") && i + 1 < argc) check_dir = argv[++i];
+    else if (!std::strcmp(argv[i], "--file")  && i + 1 < argc) file = argv[++i];
+    else if (!std::strcmp(argv[i], "--games") && i + 1 < argc) games = std::atoi(argv[++i]);
+    else paths.push_back(argv[i]);
+  }
+  if (!check_dir.empty() && paths.empty()) return check(check_dir, file, games);
+  if (paths.size() != 2) {
+    std::fprintf(stderr, "usage: %s <game.json> <out.bin>\n       %s --check DIR [--file F] [--games N]\n", argv[0],
+                 argv[0]);
+    return 2;
+  }
+  try {
+    std::size_t n = 0;
+    convert(paths[0], paths[1], &n);
+    std::printf("%zu events -> %s\n", n, paths[1].c_str());
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,194 @@
+// ---- matching_engine.hpp (price-time priority limit order book) ---------------
+// Single-instrument matching engine on the 0.1-tick [0, 100] price grid.
+// Each price level is an intrusive FIFO of pool-allocated orders, so adding,
+// matching and cancelling never search or allocate in steady state.
+// Order ids encode the pool slot, which makes cancel O(1) without a map.
+//
+// Results are reported synchronously to a Listener:
+//   on_trade(aggressor_side, qty, tick, maker, taker_owner)  per match
+//   on_fill(owner, id, side, qty, tick)                        per side of a match
+//   on_level(side, tick, total_qty)                            after a level changes
+#pragma once
+
+#include "engine_api.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace sim {
+
+using OrderId = std::int64_t;
+
+struct Order {
+  OrderId       id;            // -1 while free
+  std::uint32_t slot, gen;     // pool position and reuse count
+  std::uint32_t owner;
+  Side          side;
+  std::int16_t  tick;
+  float         qty;
+  Order        *prev, *next;   // level FIFO, or free list via next
+};
+
+// Slab pool with stable addresses. Slots are recycled through a free list;
+// the slot's generation goes into the id's high bits to reject stale cancels.
+class OrderPool {
+public:
+  static constexpr std::uint32_t kChunk = 4096;
+
+  Order *alloc() {
+    if (!free_) grow_();
+    Order *o = free_;
+    free_ = o->next;
+    return o;
+  }
+  void release(Order *o) { o->id = -1; o->qty = 0.0f; o->next = free_; free_ = o; }
+
+  Order *at(std::uint32_t slot) const {
+    return slot / kChunk < chunks_.size() ? &chunks_[slot / kChunk][slot % kChunk] : nullptr;
+  }
+
+private:
+  void grow_() {
+    std::uint32_t first = std::uint32_t(chunks_.size()) * kChunk;
+    chunks_.emplace_back(new Order[kChunk]);
+    Order *c = chunks_.back().get();
+    for (std::uint32_t i = kChunk; i-- > 0;) {
+      c[i] = Order{-1, first + i, 0, 0, Side::buy, 0, 0.0f, nullptr, free_};
+      free_ = &c[i];
+    }
+  }
+
+  std::vector<std::unique_ptr<Order[]>> chunks_;
+  Order *free_ = nullptr;
+};
+
+template <class Listener>
+class MatchingEngine {
+public:
+  static constexpr int kMaxTick = 1000;
+
+  explicit MatchingEngine(Listener &l) : l_(l) {}
+
+  // Limit order. Matches what crosses, then rests the remainder unless ioc.
+  // Returns the order id, or -1 if rejected (bad quantity or price).
+  OrderId limit(std::uint32_t owner, Side side, float qty, int tick, bool ioc) {
+    if (!(qty > 0.0f) || tick < 0 || tick > kMaxTick) return -1;
+    OrderId id = next_id_(side);
+    float left = match_(owner, id, side, qty, tick);
+    if (left > 0.0f && !ioc) rest_(owner, id, side, left, tick);
+    else if (Order *o = pending_) { pool_.release(o); pending_ = nullptr; }
+    return id;
+  }
+
+  // Market order: matches against any price, never rests. Returns unfilled qty.
+  float market(std::uint32_t owner, Side side, float qty) {
+    if (!(qty > 0.0f)) return qty;
+    OrderId id = next_id_(side);
+    float left = match_(owner, id, side, qty, side == Side::buy ? kMaxTick : 0);
+    if (Order *o = pending_) { pool_.release(o); pending_ = nullptr; }
+    return left;
+  }
+
+  bool cancel(OrderId id) {
+    Order *o = find_(id);
+    if (!o) return false;
+    Level &lv = level_(o->side, o->tick);
+    unlink_(lv, o);
+    lv.qty -= o->qty;
+    if (lv.head == nullptr) lv.qty = 0.0f;
+    int tick = o->tick;
+    Side side = o->side;
+    pool_.release(o);
+    fix_best_(side);
+    l_.on_level(side, tick, lv.qty);
+    return true;
+  }
+
+  float level_qty(Side side, int tick) const { return level_(side, tick).qty; }
+  int   best_bid() const { return best_bid_; }   // -1 if none
+  int   best_ask() const { return best_ask_; }   // kMaxTick + 1 if none
+  const Order *find(OrderId id) const { return find_(id); }
+
+private:
+  struct Level { Order *head = nullptr, *tail = nullptr; float qty = 0.0f; };
+
+  Level       &level_(Side s, int t)       { return s == Side::buy ? bids_[t] : asks_[t]; }
+  const Level &level_(Side s, int t) const { return s == Side::buy ? bids_[t] : asks_[t]; }
+
+  // Ids are (generation << 32) | slot; the slot is reserved up front so
+  // the id exists before matching reports fills against it.
+  OrderId next_id_(Side side) {
+    Order *o = pool_.alloc();
+    o->id = (OrderId(++o->gen) << 32) | o->slot;
+    o->side = side;
+    pending_ = o;
+    return o->id;
+  }
+
+  Order *find_(OrderId id) const {
+    if (id < 0) return nullptr;
+    Order *o = pool_.at(std::uint32_t(id & 0xFFFFFFFF));
+    return o && o->id == id && o->qty > 0.0f && o != pending_ ? o : nullptr;
+  }
+
+  float match_(std::uint32_t owner, OrderId id, Side side, float qty, int limit) {
+    Side maker_side = side == Side::buy ? Side::sell : Side::buy;
+    while (qty > 0.0f) {
+      int t = side == Side::buy ? best_ask_ : best_bid_;
+      if (side == Side::buy ? (t > limit || t > kMaxTick) : (t < limit || t < 0)) break;
+      Level &lv = level_(maker_side, t);
+      while (qty > 0.0f && lv.head) {
+        Order *m = lv.head;
+        float q = m->qty < qty ? m->qty : qty;
+        m->qty -= q;
+        lv.qty -= q;
+        qty -= q;
+        l_.on_trade(side, q, t, *m, owner);
+        l_.on_fill(m->owner, m->id, maker_side, q, t);
+        l_.on_fill(owner, id, side, q, t);
+        if (m->qty <= 0.0f) { unlink_(lv, m); pool_.release(m); }
+      }
+      if (!lv.head) lv.qty = 0.0f;
+      fix_best_(maker_side);
+      l_.on_level(maker_side, t, lv.qty);
+    }
+    return qty;
+  }
+
+  void rest_(std::uint32_t owner, OrderId id, Side side, float qty, int tick) {
+    Order *o = pending_;
+    pending_ = nullptr;
+    o->id = id; o->owner = owner; o->side = side; o->tick = std::int16_t(tick); o->qty = qty;
+    Level &lv = level_(side, tick);
+    o->prev = lv.tail;
+    o->next = nullptr;
+    if (lv.tail) lv.tail->next = o; else lv.head = o;
+    lv.tail = o;
+    lv.qty += qty;
+    if (side == Side::buy) { if (tick > best_bid_) best_bid_ = tick; }
+    else                   { if (tick < best_ask_) best_ask_ = tick; }
+    l_.on_level(side, tick, lv.qty);
+  }
+
+  static void unlink_(Level &lv, Order *o) {
+    if (o->prev) o->prev->next = o->next; else lv.head = o->next;
+    if (o->next) o->next->prev = o->prev; else lv.tail = o->prev;
+    o->prev = o->next = nullptr;
+  }
+
+  void fix_best_(Side s) {
+    if (s == Side::buy) while (best_bid_ >= 0 && !bids_[best_bid_].head) --best_bid_;
+    else                while (best_ask_ <= kMaxTick && !asks_[best_ask_].head) ++best_ask_;
+  }
+
+  Listener &l_;
+  OrderPool pool_;
+  Order    *pending_ = nullptr;   // slot reserved for the incoming order
+  Level     bids_[kMaxTick + 1];
+  Level     asks_[kMaxTick + 1];
+  int       best_bid_ = -1;
+  int       best_ask_ = kMaxTick + 1;
+};
+
+} // namespace sim
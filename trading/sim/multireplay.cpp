@@ -0,0 +1,140 @@
+// ---- multireplay.cpp (many games at once, one per pinned core) ----------------
+// Replays every (game file x seed) pair concurrently on the work-stealing pool
+// (sim/thread_pool.hpp, as sweep uses): each worker is pinned to a core and
+// replays one game at a time with its own Strategy, venue and matching book. Workers never share mutable state; per-game PnL goes to that
+// game's slot and the counters to the worker's own cache line, and both are
+// merged after the join, in game order, so results do not depend on the
+// thread count or scheduling. --scaling repeats the run at 1, 2, 4, ... workers
+// and prints the speed-up, to check throughput grows with cores.
+// --half-spread sets the market maker's touch distance, as in replay.
+//
+//   g++ -std=c++20 -O2 -pthread -o multireplay trading/sim/multireplay.cpp trading/sim/engine_api.cpp
+//   ./multireplay --file trading/Data/example-game.json --seeds 1000 --scaling
+#include "replay.hpp"
+#include "thread_pool.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Totals {
+  double        volume = 0.0;
+  std::uint64_t orders = 0, cancels = 0, fills = 0, games = 0;
+  sim::CallbackStat cb[std::size_t(sim::Cb::COUNT)];
+
+  void add(const sim::ReplayResult &r) {
+    volume += r.volume; orders += r.orders; cancels += r.cancels; fills += r.fills; ++games;
+    for (std::size_t k = 0; k < std::size_t(sim::Cb::COUNT); ++k) cb[k].merge(r.cb[k]);
+  }
+  void merge(const Totals &o) {
+    volume += o.volume; orders += o.orders; cancels += o.cancels; fills += o.fills; games += o.games;
+    for (std::size_t k = 0; k < std::size_t(sim::Cb::COUNT); ++k) cb[k].merge(o.cb[k]);
+  }
+};
+
+struct Run {
+  std::vector<double> pnl;                        // per game, in game order
+  std::vector<sim::PerWorker<Totals>> workers;
+  Totals total;
+  double secs = 0.0;
+};
+
+Run run(const std::vector<std::vector<Strategy::GameEvent>> &games, const sim::MarketParams &market, int seeds,
+        unsigned threads, bool pin) {
+  const std::size_t tasks = games.size() * std::size_t(seeds);
+  sim::WorkStealingPool pool(threads, pin);
+  Run r;
+  r.pnl.resize(tasks);
+  r.workers.resize(pool.size());
+
+  auto t0 = std::chrono::steady_clock::now();
+  pool.parallel_for(tasks, [&](std::size_t i, unsigned w) {
+    std::size_t g = i / std::size_t(seeds), s = i % std::size_t(seeds);
+    sim::ReplayResult res = sim::replay_game(games[g], market, 1 + s);
+    r.pnl[i] = res.pnl;
+    r.workers[w].value.add(res);
+  });
+  r.secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  for (const sim::PerWorker<Totals> &w : r.workers) r.total.merge(w.value);
+  return r;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<std::string> files;
+  int seeds = 100;
+  unsigned threads = 0;
+  bool pin = true, scaling = false;
+  sim::MarketParams market;
+  for (int i = 1; i < argc; ++i) {
+    if      (!std::strcmp(argv[i], "--file")    && i + 1 < argc) files.push_back(argv[++i]);
+    else if (!std::strcmp(argv[i], "--seeds")   && i + 1 < argc) seeds = std::max(1, std::atoi(argv[++i]));
+    else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = unsigned(std::atoi(argv[++i]));
+    else if (!std::strcmp(argv[i], "--half-spread") && i + 1 < argc) market.half_spread = std::max(1, std::atoi(argv[++i]));
+    else if (!std::strcmp(argv[i], "--no-pin"))  pin = false;
+    else if (!std::strcmp(argv[i], "--scaling")) scaling = true;
+    else {
+      std::fprintf(stderr,
+                   "usage: %s --file F [--file F...] [--seeds N] [--threads T] [--half-spread TICKS] [--no-pin] "
+                   "[--scaling]\n",
+                   argv[0]);
+      return 2;
+    }
+  }
+  if (files.empty()) files.push_back("trading/Data/example-game.json");
+
+  std::vector<std::vector<Strategy::GameEvent>> games;
+  std::size_t events = 0;
+  try {
+    for (const std::string &f : files) games.push_back(sim::load_game(f));
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  for (const auto &g : games) events += g.size();
+  events *= std::size_t(seeds);
+
+  const unsigned max_threads = sim::WorkStealingPool(threads, pin).size();
+  if (scaling) {
+    std::printf("%8s %10s %12s %12s %10s\n", "workers", "wall s", "games/s", "Mevents/s", "speed-up");
+    double base = 0.0;
+    for (unsigned t = 1;; t = std::min(t * 2, max_threads)) {
+      Run r = run(games, market, seeds, t, pin);
+      if (t == 1) base = r.secs;
+      std::printf("%8u %10.3f %12.0f %12.2f %10.2f\n", t, r.secs, double(r.pnl.size()) / r.secs,
+                  double(events) / r.secs * 1e-6, base / r.secs);
+      if (t == max_threads) break;
+    }
+    std::printf("\n");
+  }
+
+  Run r = run(games, market, seeds, max_threads, pin);
+  sim::WorkStealingPool pool(max_threads, pin);
+  double pnl_sum = 0.0, pnl_sq = 0.0;
+  for (double p : r.pnl) { pnl_sum += p; pnl_sq += p * p; }
+
+  const double n = double(r.pnl.size());
+  const double mean = pnl_sum / n;
+  std::printf("%zu games x %d seeds = %zu replays on %u workers (%s) in %.3fs  %.0f games/s\n", games.size(), seeds,
+              r.pnl.size(), pool.size(), pool.pinned() ? "pinned" : "unpinned", r.secs, n / r.secs);
+  std::printf("pnl mean %.2f  sd %.2f  orders/game %.1f  cancels/game %.1f  fills/game %.1f  volume/game %.1f\n",
+              mean, std::sqrt(std::max(0.0, pnl_sq / n - mean * mean)), double(r.total.orders) / n,
+              double(r.total.cancels) / n, double(r.total.fills) / n, r.total.volume / n);
+  std::printf("%-8s %6s %10s\n", "worker", "cpu", "games");
+  for (unsigned w = 0; w < pool.size(); ++w)
+    std::printf("%-8u %6d %10llu\n", w, pool.cpu_of(w), (unsigned long long)r.workers[w].value.games);
+  std::printf("%-24s %12s %10s %10s\n", "callback", "calls", "mean ns", "max ns");
+  for (std::size_t k = 0; k < std::size_t(sim::Cb::COUNT); ++k) {
+    const sim::CallbackStat &c = r.total.cb[k];
+    std::printf("%-24s %12llu %10.1f %10llu\n", sim::kCbNames[k], (unsigned long long)c.n, c.mean_ns(),
+                (unsigned long long)c.max_ns);
+  }
+  return 0;
+}
@@ -0,0 +1,54 @@
+// ---- params.hpp (Strategy::RuntimeCfg by name) --------------------------------
+#pragma once
+
+#include "strategy.hpp"
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace sim {
+
+// Every field of Strategy::RuntimeCfg, addressable by its Cfg name.
+template <class F>
+void for_each_param(Strategy::RuntimeCfg &c, F &&f) {
+  f("MAX_POS", c.MAX_POS);
+  f("RISK_PCT_PER_TRADE", c.RISK_PCT_PER_TRADE);
+  f("POSITION_NUDGE_LATE", c.POSITION_NUDGE_LATE);
+  f("MAX_SPREAD_TO_CROSS", c.MAX_SPREAD_TO_CROSS);
+  f("PASSIVE_IMPROVE", c.PASSIVE_IMPROVE);
+  f("COALESCE_BOOK_UPDATES", c.COALESCE_BOOK_UPDATES);
+  f("QUEUE_HALF_QTY", c.QUEUE_HALF_QTY);
+  f("REQUOTE_HURDLE", c.REQUOTE_HURDLE);
+  f("HOME_ADV_POINTS", c.HOME_ADV_POINTS);
+  f("LOGIT_W_LEAD", c.LOGIT_W_LEAD);
+  f("LOGIT_W_MOM", c.LOGIT_W_MOM);
+  f("LOGIT_W_HOME", c.LOGIT_W_HOME);
+  f("MOM_EMA_ALPHA", c.MOM_EMA_ALPHA);
+  f("BASE_EDGE_THRESH", c.BASE_EDGE_THRESH);
+  f("LATE_TIGHTEN", c.LATE_TIGHTEN);
+  f("FEATURE_WINDOW_SEC", c.FEATURE_WINDOW_SEC);
+  f("INIT_COOLDOWN_SEC", c.INIT_COOLDOWN_SEC);
+  f("CLOSE_OUT_BUFFER_SEC", c.CLOSE_OUT_BUFFER_SEC);
+}
+
+// Returns false for an unknown name. Tick fields take whole ticks.
+inline bool set_param(Strategy::RuntimeCfg &c, std::string_view name, double v) {
+  bool found = false;
+  for_each_param(c, [&](std::string_view n, auto &field) {
+    if (n != name) return;
+    field = static_cast<std::remove_reference_t<decltype(field)>>(v);
+    found = true;
+  });
+  return found;
+}
+
+inline std::string param_list() {
+  std::string out;
+  Strategy::RuntimeCfg c;
+  for_each_param(c, [&](std::string_view n, auto &) { out += out.empty() ? "" : " "; out += n; });
+  return out;
+}
+
+} // namespace sim
@@ -0,0 +1,39 @@
+// ---- replay.hpp (one game through a Strategy + sim::BasicVenue) ---------------
+#pragma once
+
+#include "game_bin.hpp"
+#include "venue.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+// Replays one game from a fresh Strategy. Simulated time advances by the
+// drop in time_seconds between events, so the start-up cooldown and the
+// late-game logic see game time rather than wall time. Events may be
+// GameEvents or mapped EventRecords; S picks the Strategy instantiation.
+template <class S = Strategy, class Events>
+ReplayResult replay_game(const Events &events, const MarketParams &params, std::uint64_t seed,
+                         const typename S::Params &cfg = {}, bool verbose = false) {
+  g_clock = 0.0;
+  S strat(cfg);
+  BasicVenue<S> venue(strat, params, seed);
+  venue.verbose = verbose;
+  OrderSink::Bind bind(venue);
+
+  venue.open();
+  double prev_t = Strategy::Cfg::GAME_LEN2;
+  for (const auto &rec : events) {
+    const Strategy::GameEvent &ev = to_event(rec);
+    if (ev.time_seconds) {
+      g_clock += std::max(0.0, prev_t - *ev.time_seconds);
+      prev_t = *ev.time_seconds;
+    }
+    venue.on_event(ev);
+  }
+  return venue.result();
+}
+
+} // namespace sim
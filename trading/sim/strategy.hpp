@@ -0,0 +1,17 @@
+// ---- strategy.hpp (offline build of kwokker_algo.hpp) -------------------------
+// Pulls the drop-in strategy into native tools with the cooldown clock bound
+// to simulated time. Tools pick Strategy (production constants) or
+// ResearchStrategy (runtime Cfg). Include this instead of kwokker_algo.hpp.
+#pragma once
+
+#include "engine_api.hpp"
+
+namespace sim {
+// Simulated seconds since the current replay began. Per thread, so parallel
+// drivers can run independent replays.
+inline thread_local double g_clock = 0.0;
+inline double now_sec() { return g_clock; }
+} // namespace sim
+
+#define KWOKKER_NOW_SEC() ::sim::now_sec()
+#include "../kwokker_algo.hpp"
@@ -0,0 +1,150 @@
+// ---- sweep.cpp (parallel ResearchStrategy grid search) ------------------------
+// Replays every (config x game x seed) combination on a work-stealing pool,
+// one ResearchStrategy and venue per task, and prints a PnL table per config (and a
+// grid when exactly two parameters are swept). --half-spread sets the market
+// maker's touch distance, as in replay; the quote-keeping parameters
+// (QUEUE_HALF_QTY, REQUOTE_HURDLE) only matter once it is wide enough for the
+// strategy to rest passives, from about 10 ticks.
+//
+//   g++ -std=c++20 -O2 -pthread -o sweep trading/sim/sweep.cpp trading/sim/engine_api.cpp
+//   ./sweep --file example-game.bin --seeds 50 --param BASE_EDGE_THRESH=0.5,0.9,1.3 --param MAX_POS=600,1200
+//   ./sweep --half-spread 20 --param REQUOTE_HURDLE=0,0.25,0.5 --param QUEUE_HALF_QTY=100,200,400
+#include "params.hpp"
+#include "replay.hpp"
+#include "thread_pool.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Axis {
+  std::string name;
+  std::vector<double> values;
+};
+
+bool parse_axis(const char *arg, Axis &out) {
+  const char *eq = std::strchr(arg, '=');
+  if (!eq) return false;
+  out.name.assign(arg, eq);
+  for (const char *p = eq + 1; *p;) {
+    char *end = nullptr;
+    out.values.push_back(std::strtod(p, &end));
+    if (end == p) return false;
+    p = *end == ',' ? end + 1 : end;
+  }
+  return !out.values.empty();
+}
+
+struct Summary {
+  double sum = 0.0, sq = 0.0, fills = 0.0, orders = 0.0, cancels = 0.0;
+  std::size_t n = 0;
+  double mean() const { return n ? sum / double(n) : 0.0; }
+  double sd() const { return n ? std::sqrt(std::max(0.0, sq / double(n) - mean() * mean())) : 0.0; }
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<std::string> files;
+  std::vector<Axis> axes;
+  int seeds = 20;
+  unsigned threads = 0;
+  sim::MarketParams market;
+  for (int i = 1; i < argc; ++i) {
+    Axis a;
+    if      (!std::strcmp(argv[i], "--file")    && i + 1 < argc) files.push_back(argv[++i]);
+    else if (!std::strcmp(argv[i], "--seeds")   && i + 1 < argc) seeds = std::max(1, std::atoi(argv[++i]));
+    else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = unsigned(std::atoi(argv[++i]));
+    else if (!std::strcmp(argv[i], "--param")   && i + 1 < argc && parse_axis(argv[++i], a)) axes.push_back(a);
+    else if (!std::strcmp(argv[i], "--half-spread") && i + 1 < argc) market.half_spread = std::max(1, std::atoi(argv[++i]));
+    else {
+      std::fprintf(stderr, "usage: %s --file F [--file F...] [--seeds N] [--threads T] [--half-spread TICKS]\n"
+                           "          [--param NAME=v1,v2,...]\n"
+                           "params: %s\n", argv[0], sim::param_list().c_str());
+      return 2;
+    }
+  }
+  if (files.empty()) files.push_back("trading/Data/example-game.json");
+
+  // Expand the grid (last axis fastest).
+  std::vector<Strategy::RuntimeCfg> configs(1);
+  for (const Axis &a : axes) {
+    std::vector<Strategy::RuntimeCfg> next;
+    for (const Strategy::RuntimeCfg &c : configs) {
+      for (double v : a.values) {
+        Strategy::RuntimeCfg cv = c;
+        if (!sim::set_param(cv, a.name, v)) {
+          std::fprintf(stderr, "unknown param %s (have: %s)\n", a.name.c_str(), sim::param_list().c_str());
+          return 2;
+        }
+        next.push_back(cv);
+      }
+    }
+    configs.swap(next);
+  }
+
+  std::vector<std::vector<Strategy::GameEvent>> games;
+  try {
+    for (const std::string &f : files) games.push_back(sim::load_game(f));
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  const std::size_t per_config = games.size() * std::size_t(seeds);
+  const std::size_t tasks = configs.size() * per_config;
+  std::vector<sim::ReplayResult> results(tasks);
+  sim::WorkStealingPool pool(threads);
+
+  auto t0 = std::chrono::steady_clock::now();
+  pool.parallel_for(tasks, [&](std::size_t i, unsigned) {
+    std::size_t c = i / per_config, rem = i % per_config;
+    std::size_t g = rem / std::size_t(seeds), s = rem % std::size_t(seeds);
+    results[i] = sim::replay_game<ResearchStrategy>(games[g], market, 1 + s, configs[c]);
+  });
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  std::vector<Summary> sums(configs.size());
+  for (std::size_t i = 0; i < tasks; ++i) {
+    Summary &s = sums[i / per_config];
+    const sim::ReplayResult &r = results[i];
+    s.sum += r.pnl; s.sq += r.pnl * r.pnl; s.fills += r.fills; s.orders += r.orders; s.cancels += r.cancels; ++s.n;
+  }
+
+  std::printf("%zu configs x %zu games x %d seeds = %zu replays on %u threads in %.2fs (%.0f replays/s)\n",
+              configs.size(), games.size(), seeds, tasks, pool.size(), secs, double(tasks) / secs);
+  for (const Axis &a : axes) std::printf("%-20s ", a.name.c_str());
+  std::printf("%12s %12s %10s %10s %10s\n", "pnl mean", "pnl sd", "fills", "orders", "cancels");
+  std::size_t best = 0;
+  for (std::size_t c = 0; c < configs.size(); ++c) {
+    std::size_t stride = configs.size();
+    for (const Axis &a : axes) {
+      stride /= a.values.size();
+      std::printf("%-20g ", a.values[(c / stride) % a.values.size()]);
+    }
+    const Summary &s = sums[c];
+    std::printf("%12.2f %12.2f %10.1f %10.1f %10.1f\n", s.mean(), s.sd(), s.fills / double(s.n), s.orders / double(s.n),
+                s.cancels / double(s.n));
+    if (s.mean() > sums[best].mean()) best = c;
+  }
+
+  if (axes.size() == 2) {
+    const Axis &row = axes[0], &col = axes[1];
+    std::printf("\nmean pnl: rows %s, cols %s\n%12s", row.name.c_str(), col.name.c_str(), "");
+    for (double v : col.values) std::printf(" %12g", v);
+    std::printf("\n");
+    for (std::size_t r = 0; r < row.values.size(); ++r) {
+      std::printf("%12g", row.values[r]);
+      for (std::size_t k = 0; k < col.values.size(); ++k) std::printf(" %12.2f", sums[r * col.values.size() + k].mean());
+      std::printf("\n");
+    }
+  }
+  std::printf("\nbest config #%zu: mean pnl %.2f\n", best, sums[best].mean());
+  return 0;
+}
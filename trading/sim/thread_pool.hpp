@@ -0,0 +1,122 @@
+// ---- thread_pool.hpp (work-stealing parallel_for, optionally core-pinned) ----
+// Runs fn(i) for i in [0, n) on a fixed set of threads. Each worker starts
+// with a contiguous block of indices in its own deque, pops from the back,
+// and steals from the front of other workers' deques when it runs dry, so
+// uneven task costs (long games, slow configs) balance out. Workers only
+// write their own slot of whatever fn touches; the caller merges after.
+//
+// With pinning on, worker w runs on the (w mod count)-th CPU of the process
+// affinity mask (so taskset/cgroup limits hold). Pinning is Linux-only and
+// best-effort: elsewhere, or if the call fails, workers run unpinned. The
+// default thread count is the number of CPUs in that mask.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace sim {
+
+// Own cache line per worker, for per-worker accumulators written in the hot loop.
+template <class T>
+struct alignas(64) PerWorker {
+  T value{};
+};
+
+class WorkStealingPool {
+public:
+  explicit WorkStealingPool(unsigned threads = 0, bool pin = false) : cpus_(allowed_cpus_()) {
+    n_ = threads ? threads : cpus_.empty() ? std::max(1u, std::thread::hardware_concurrency()) : unsigned(cpus_.size());
+    if (!pin) cpus_.clear();
+  }
+
+  unsigned size() const { return n_; }
+  bool pinned() const { return !cpus_.empty(); }
+  // CPU worker w is pinned to, or -1.
+  int cpu_of(unsigned w) const { return cpus_.empty() ? -1 : cpus_[w % cpus_.size()]; }
+
+  // fn(index, worker) must only touch state owned by that index or worker.
+  template <class F>
+  void parallel_for(std::size_t n, F &&fn) {
+    std::vector<Queue> qs(n_);
+    for (unsigned w = 0; w < n_; ++w) {
+      std::size_t lo = n * w / n_, hi = n * (w + 1) / n_;
+      for (std::size_t i = lo; i < hi; ++i) qs[w].items.push_back(i);
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(n_);
+    for (unsigned w = 0; w < n_; ++w) {
+      threads.emplace_back([&, w] {
+        pin_(cpu_of(w));
+        std::size_t i;
+        while (pop_(qs[w], i) || steal_(qs, w, i)) fn(i, w);
+      });
+    }
+    for (std::thread &t : threads) t.join();
+  }
+
+private:
+  struct Queue {
+    std::mutex m;
+    std::deque<std::size_t> items;
+  };
+
+  static bool pop_(Queue &q, std::size_t &out) {
+    std::lock_guard<std::mutex> lk(q.m);
+    if (q.items.empty()) return false;
+    out = q.items.back();
+    q.items.pop_back();
+    return true;
+  }
+
+  // Nothing is ever pushed after start, so one empty pass means done.
+  bool steal_(std::vector<Queue> &qs, unsigned self, std::size_t &out) const {
+    for (unsigned k = 1; k < n_; ++k) {
+      Queue &q = qs[(self + k) % n_];
+      std::lock_guard<std::mutex> lk(q.m);
+      if (q.items.empty()) continue;
+      out = q.items.front();
+      q.items.pop_front();
+      return true;
+    }
+    return false;
+  }
+
+  static std::vector<int> allowed_cpus_() {
+    std::vector<int> out;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof set, &set) == 0)
+      for (int c = 0; c < CPU_SETSIZE; ++c)
+        if (CPU_ISSET(c, &set)) out.push_back(c);
+#endif
+    return out;
+  }
+
+  static void pin_(int cpu) {
+#ifdef __linux__
+    if (cpu < 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+#else
+    (void)cpu;
+#endif
+  }
+
+  std::vector<int> cpus_;
+  unsigned n_;
+};
+
+} // namespace sim
@@ -0,0 +1,333 @@
+// ---- venue.hpp (simulated exchange for offline replays) -----------------------
+// One market maker quotes a ladder around its own noisy win-probability
+// estimate into a price-time MatchingEngine; the strategy trades in the same
+// book through the free functions the sandbox provides. Callbacks the engine
+// would send asynchronously are queued and delivered after the current
+// strategy callback returns, in engine order: trades, then the book levels
+// they changed, then the strategy's own fills.
+#pragma once
+
+#include "matching_engine.hpp"
+#include "strategy.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+constexpr int   kMaxTick  = MatchingEngine<struct AnyListener>::kMaxTick;   // 100.0 / kTickSize
+
+constexpr float kTickSize = 0.1f;
+
+inline int   to_tick(float price) { return std::clamp(int(std::lround(price / kTickSize)), 0, kMaxTick); }
+inline float to_price(int tick)   { return float(tick) * kTickSize; }
+
+// ───────── Market model ─────────
+struct MarketParams {
+  float lead_w      = 0.16f;      // logit weight on time-scaled lead
+  float home_w      = 0.25f;      // logit weight on time-scaled home edge
+  float noise_sd    = 0.01f;      // logit random walk per game event
+  int   half_spread = 5;          // ticks from MM fair to each touch
+  int   depth       = 5;          // MM levels per side
+  float level_qty   = 100.0f;     // MM size per level
+  float capital     = 100000.0f;  // strategy starting capital
+};
+
+// splitmix64: small, seedable, identical across platforms
+struct Rng {
+  std::uint64_t s;
+  explicit Rng(std::uint64_t seed) : s(seed) {}
+  std::uint64_t next() {
+    std::uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+  double uniform() { return double(next() >> 11) * (1.0 / 9007199254740992.0); }
+  double normal() {
+    double u = std::max(uniform(), 1e-300), v = uniform();
+    return std::sqrt(-2.0 * std::log(u)) * std::cos(6.283185307179586 * v);
+  }
+};
+
+// ───────── Results ─────────
+enum class Cb : std::uint8_t { TRADE, BOOK, SNAPSHOT, ACCOUNT, GAME, COUNT };
+constexpr const char *kCbNames[] = {"on_trade_update", "on_orderbook_update", "on_orderbook_snapshot",
+                                    "on_account_update", "on_game_event_update"};
+
+struct CallbackStat {
+  std::uint64_t n = 0, total_ns = 0, max_ns = 0;
+  void add(std::uint64_t ns) { ++n; total_ns += ns; max_ns = std::max(max_ns, ns); }
+  void merge(const CallbackStat &o) { n += o.n; total_ns += o.total_ns; max_ns = std::max(max_ns, o.max_ns); }
+  double mean_ns() const { return n ? double(total_ns) / double(n) : 0.0; }
+};
+
+struct ReplayResult {
+  double        pnl = 0.0;            // cash + settled position, vs. starting capital
+  double        pnl_marked = 0.0;     // the same at END_GAME, before the strategy's close-out
+  double        pnl_books = 0.0;      // the strategy's own accounting of pnl_marked
+  double        volume = 0.0;         // contracts traded
+  std::uint32_t orders = 0, cancels = 0, fills = 0, log_lines = 0;
+  CallbackStat  cb[std::size_t(Cb::COUNT)];
+};
+
+// ───────── Order sink ─────────
+// What the free engine functions talk to; bound per thread.
+class OrderSink {
+public:
+  virtual ~OrderSink() = default;
+  virtual bool market_order(Side side, float qty) = 0;
+  virtual std::int64_t limit_order(Side side, float qty, float price, bool ioc) = 0;
+  virtual bool cancel(std::int64_t id) = 0;
+  virtual void log(const std::string &text) = 0;
+
+  struct Bind {
+    OrderSink *prev;
+    explicit Bind(OrderSink &s) : prev(cur_()) { cur_() = &s; }
+    ~Bind() { cur_() = prev; }
+  };
+  static OrderSink *current() { return cur_(); }
+
+private:
+  static OrderSink *&cur_() { static thread_local OrderSink *s = nullptr; return s; }
+};
+
+// ───────── Venue ─────────
+// S is any BasicStrategy instantiation (Strategy, ResearchStrategy, ...).
+template <class S>
+class BasicVenue final : public OrderSink {
+public:
+  static constexpr std::uint32_t kStrategy = 0, kMaker = 1;   // engine owners
+
+  BasicVenue(S &strat, const MarketParams &p, std::uint64_t seed)
+      : strat_(strat), p_(p), rng_(seed), eng_(*this) {
+    pending_.reserve(1024);
+    account_.reserve(64);
+    dirty_.reserve(4 * (kMaxTick + 1));
+    std::fill(std::begin(mm_bid_id_), std::end(mm_bid_id_), OrderId(-1));
+    std::fill(std::begin(mm_ask_id_), std::end(mm_ask_id_), OrderId(-1));
+  }
+
+  bool verbose = false;
+
+  // ───────── Engine API ─────────
+  bool market_order(Side side, float qty) override {
+    ++res_.orders;
+    if (qty < 1.0f) return false;
+    eng_.market(kStrategy, side, std::floor(qty));
+    flush_book_();
+    return true;
+  }
+
+  std::int64_t limit_order(Side side, float qty, float price, bool ioc) override {
+    ++res_.orders;
+    if (qty < 1.0f || price < 0.0f || price > 100.0f) return -1;
+    OrderId id = eng_.limit(kStrategy, side, std::floor(qty), to_tick(price), ioc);
+    flush_book_();
+    return id;
+  }
+
+  bool cancel(std::int64_t id) override {
+    ++res_.cancels;
+    const Order *o = eng_.find(id);
+    if (!o || o->owner != kStrategy) return false;
+    eng_.cancel(id);
+    flush_book_();
+    return true;
+  }
+
+  void log(const std::string &text) override {
+    ++res_.log_lines;
+    if (verbose) std::fprintf(stderr, "[strategy] %s\n", text.c_str());
+  }
+
+  // ───────── Engine listener ─────────
+  void on_trade(Side aggressor, float qty, int tick, const Order &, std::uint32_t) {
+    pending_.push_back({Cb::TRADE, aggressor, qty, to_price(tick), 0.0f});
+  }
+  void on_fill(std::uint32_t owner, OrderId, Side side, float qty, int tick) {
+    if (owner != kStrategy) return;
+    float signed_qty = side == Side::buy ? qty : -qty;
+    float price = to_price(tick);
+    position_ += signed_qty;
+    cash_ -= double(signed_qty) * price;
+    res_.volume += qty;
+    ++res_.fills;
+    account_.push_back({Cb::ACCOUNT, side, signed_qty, price, float(p_.capital + cash_)});
+  }
+  void on_level(Side side, int tick, float) { mark_(side, tick); }
+
+  // ───────── Driver ─────────
+  // Publish the opening book as a snapshot.
+  void open() {
+    requote_();
+    for (int k : dirty_) pub_(k) = level_(k);
+    clear_dirty_();
+    account_.clear();
+    snap_bids_.clear();
+    snap_asks_.clear();
+    for (int t = kMaxTick; t >= 0; --t) if (pub_bid_[t] > 0.0f) snap_bids_.push_back({to_price(t), pub_bid_[t]});
+    for (int t = 0; t <= kMaxTick; ++t) if (pub_ask_[t] > 0.0f) snap_asks_.push_back({to_price(t), pub_ask_[t]});
+    timed_(Cb::SNAPSHOT, [&] { strat_.on_orderbook_snapshot(Ticker::TEAM_A, snap_bids_, snap_asks_); });
+    pump_();
+  }
+
+  // Deliver one game event, then let the market maker react to it.
+  void on_event(const Strategy::GameEvent &ev) {
+    lead_ = float(ev.home_score - ev.away_score);
+    if (ev.time_seconds) t_rem_ = float(*ev.time_seconds);
+    const bool  end = ev.type == Strategy::EventType::END_GAME;
+    const float settle = ev.home_score > ev.away_score ? 100.0f : 0.0f;
+    if (end) res_.pnl_marked = cash_ + position_ * settle;
+
+    timed_(Cb::GAME, [&] { strat_.on_game_event(ev); });
+    pump_();
+
+    if (end) {
+      res_.pnl = cash_ + position_ * settle;
+      res_.pnl_books = strat_.game_pnl_[0];
+      return;
+    }
+    requote_();
+    flush_book_();
+    pump_();
+  }
+
+  const ReplayResult &result() const { return res_; }
+  float position() const { return position_; }
+
+private:
+  struct Pending {
+    Cb kind; Side side; float qty, price, capital;
+  };
+
+  // Dirty-level keys: bids in [0, kMaxTick], asks offset by kMaxTick + 1.
+  static constexpr int kAsk = kMaxTick + 1;
+
+  OrderId *mm_ids_(int side) { return side == 0 ? mm_bid_id_ : mm_ask_id_; }
+  float  level_(int key) const { return key < kAsk ? eng_.level_qty(Side::buy, key) : eng_.level_qty(Side::sell, key - kAsk); }
+  float &pub_(int key)         { return key < kAsk ? pub_bid_[key] : pub_ask_[key - kAsk]; }
+
+  void mark_(Side s, int t) {
+    int key = s == Side::buy ? t : t + kAsk;
+    if (!dirty_flag_[key]) { dirty_flag_[key] = true; dirty_.push_back(key); }
+  }
+  void clear_dirty_() {
+    for (int k : dirty_) dirty_flag_[k] = false;
+    dirty_.clear();
+  }
+
+  // Reprice the market maker after a game event. Levels that keep their
+  // price and size keep their queue position; the rest are pulled first and
+  // then re-placed, which may trade against resting strategy orders.
+  void requote_() {
+    float t = std::max(t_rem_, 0.0f);
+    float scale = 1.0f / std::sqrt(t / 60.0f + 1.0f);
+    noise_ += p_.noise_sd * float(rng_.normal());
+    float logit = p_.lead_w * lead_ * scale + p_.home_w * scale + noise_;
+    float fair = 100.0f / (1.0f + std::exp(-logit));
+
+    int mid = to_tick(fair);
+    int bid_hi = std::clamp(mid - p_.half_spread, 0, kMaxTick);
+    int ask_lo = std::clamp(mid + p_.half_spread, 0, kMaxTick);
+    int bid_lo = std::max(0, bid_hi - p_.depth + 1);
+    int ask_hi = std::min(kMaxTick, ask_lo + p_.depth - 1);
+
+    auto wanted = [&](int side, int tk) { return side == 0 ? tk >= bid_lo && tk <= bid_hi : tk >= ask_lo && tk <= ask_hi; };
+    for (int side = 0; side < 2; ++side) {
+      for (int tk = mm_lo_[side]; tk <= mm_hi_[side]; ++tk) {
+        OrderId &id = mm_ids_(side)[tk];
+        if (id < 0) continue;
+        const Order *o = eng_.find(id);
+        if (o && wanted(side, tk) && o->qty == p_.level_qty) continue;
+        if (o) eng_.cancel(id);
+        id = -1;
+      }
+    }
+    place_side_(0, Side::buy, bid_lo, bid_hi);
+    place_side_(1, Side::sell, ask_lo, ask_hi);
+  }
+
+  void place_side_(int side, Side s, int lo, int hi) {
+    for (int tk = lo; tk <= hi; ++tk) {
+      OrderId &id = mm_ids_(side)[tk];
+      if (id >= 0) continue;
+      id = eng_.limit(kMaker, s, p_.level_qty, tk, /*ioc=*/false);
+      if (!eng_.find(id)) id = -1;   // fully traded on entry
+    }
+    mm_lo_[side] = lo;   // everything outside [lo, hi] was pulled above
+    mm_hi_[side] = hi;
+  }
+
+  // Emit book updates for every touched level, then the account updates
+  // for fills that caused them.
+  void flush_book_() {
+    for (int key : dirty_) {
+      float q = level_(key);
+      if (q == pub_(key)) continue;
+      pub_(key) = q;
+      Side s = key < kAsk ? Side::buy : Side::sell;
+      pending_.push_back({Cb::BOOK, s, q, to_price(key < kAsk ? key : key - kAsk), 0.0f});
+    }
+    clear_dirty_();
+    pending_.insert(pending_.end(), account_.begin(), account_.end());
+    account_.clear();
+  }
+
+  template <class F>
+  void timed_(Cb kind, F &&f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+    res_.cb[std::size_t(kind)].add(std::uint64_t(ns));
+  }
+
+  // Deliver queued callbacks; the strategy may enqueue more while we do.
+  void pump_() {
+    for (std::size_t i = 0; i < pending_.size(); ++i) {
+      Pending e = pending_[i];
+      switch (e.kind) {
+        case Cb::TRADE:   timed_(e.kind, [&] { strat_.on_trade_update(Ticker::TEAM_A, e.side, e.qty, e.price); }); break;
+        case Cb::BOOK:    timed_(e.kind, [&] { strat_.on_orderbook_update(Ticker::TEAM_A, e.side, e.qty, e.price); }); break;
+        case Cb::ACCOUNT: timed_(e.kind, [&] { strat_.on_account_update(Ticker::TEAM_A, e.side, e.price, e.qty, e.capital); }); break;
+        default: break;
+      }
+    }
+    pending_.clear();
+  }
+
+  S                      &strat_;
+  MarketParams            p_;
+  Rng                     rng_;
+  ReplayResult            res_;
+  MatchingEngine<BasicVenue> eng_;
+
+  // Market maker: its resting order per level, and the range it has used
+  OrderId mm_bid_id_[kMaxTick + 1];
+  OrderId mm_ask_id_[kMaxTick + 1];
+  int     mm_lo_[2] = {0, 0}, mm_hi_[2] = {-1, -1};
+  float   noise_ = 0.0f;
+  float   lead_ = 0.0f, t_rem_ = 2880.0f;
+
+  // Strategy account
+  float  position_ = 0.0f;
+  double cash_ = 0.0;
+
+  // Published book and delivery queue
+  float pub_bid_[kMaxTick + 1] = {};
+  float pub_ask_[kMaxTick + 1] = {};
+  bool  dirty_flag_[2 * (kMaxTick + 1)] = {};
+  std::vector<int>     dirty_;
+  std::vector<Pending> account_;
+  std::vector<Pending> pending_;
+  std::vector<std::pair<float, float>> snap_bids_, snap_asks_;
+};
+
+using Venue = BasicVenue<Strategy>;
+
+} // namespace sim
@@ -0,0 +1,159 @@
+// ---- winprob.cpp (batch win-probability scoring) ------------------------------
+// Scores game states with win_prob_batch() under one or more coefficient sets,
+// checks the result against the scalar model Strategy uses, and reports
+// throughput for both.
+//
+// States come either from game files (the lead/momentum/t_rem trajectory the
+// strategy sees, event by event) or from a CSV with lead, momentum and t_rem
+// columns plus an optional home_adv column, e.g. exported from a notebook.
+// CSVs load through the same column cache as csv2col, so a second run maps
+// the parsed columns instead of reading the text again.
+//
+//   g++ -std=c++20 -O2 -march=native -o winprob trading/sim/winprob.cpp trading/sim/engine_api.cpp
+//   ./winprob --file trading/Data/example-game.json --coefs 0.18,0.10,0.20,1.25 --coefs 0.25,0.05,0.20,1.0
+#include "columns.hpp"
+#include "game_bin.hpp"
+#include "win_prob_batch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct States {
+  std::vector<float> lead, momentum, t_rem, home_adv;
+
+  sim::WinProbInputs inputs() const { return {lead, momentum, t_rem, home_adv}; }
+};
+
+// Same state updates as BasicStrategy::on_game_event, one state per event.
+void states_from_game(const std::vector<Strategy::GameEvent> &events, States &out) {
+  using Cfg = Strategy::Cfg;
+  float t_rem = Cfg::GAME_LEN2, lead = 0.0f, momentum = 0.0f;
+  bool seen = false;
+  for (const Strategy::GameEvent &ev : events) {
+    if (ev.time_seconds) {
+      float t = float(*ev.time_seconds);
+      if (t <= Cfg::GAME_LEN1 + 1.0f) t_rem = t;
+      if (t <= Cfg::GAME_LEN2 + 1.0f) t_rem = std::max(t_rem, t);
+    }
+    float prev = lead;
+    lead = float(ev.home_score - ev.away_score);
+    momentum = seen ? (1.0f - Cfg::MOM_EMA_ALPHA) * momentum + Cfg::MOM_EMA_ALPHA * (lead - prev) : 0.0f;
+    seen = true;
+    out.lead.push_back(lead);
+    out.momentum.push_back(momentum);
+    out.t_rem.push_back(t_rem);
+    if (ev.type == Strategy::EventType::END_GAME) { lead = momentum = 0.0f; t_rem = Cfg::GAME_LEN2; seen = false; }
+  }
+}
+
+// Header-named columns, loaded through the column cache (sim/columns.hpp).
+// Rows with a missing value in a used column are skipped.
+bool states_from_csv(const std::string &path, States &out) {
+  sim::ColumnTable t = sim::ColumnTable::load(path);
+  if (!t.has("lead") || !t.has("momentum") || !t.has("t_rem")) {
+    std::fprintf(stderr, "%s: need lead, momentum and t_rem columns\n", path.c_str());
+    return false;
+  }
+  std::span<const float> lead = t.column("lead"), mom = t.column("momentum"), t_rem = t.column("t_rem");
+  std::span<const float> home = t.has("home_adv") ? t.column("home_adv") : std::span<const float>{};
+  std::size_t skipped = 0;
+  for (std::size_t i = 0; i < t.rows(); ++i) {
+    if (std::isnan(lead[i]) || std::isnan(mom[i]) || std::isnan(t_rem[i]) || (!home.empty() && std::isnan(home[i]))) {
+      ++skipped;
+      continue;
+    }
+    out.lead.push_back(lead[i]);
+    out.momentum.push_back(mom[i]);
+    out.t_rem.push_back(t_rem[i]);
+    if (!home.empty()) out.home_adv.push_back(home[i]);
+  }
+  if (skipped) std::fprintf(stderr, "%s: skipped %zu rows with missing values\n", path.c_str(), skipped);
+  return true;
+}
+
+bool parse_coefs(const char *arg, sim::LogitCoefs &k) {
+  float *dst[] = {&k.w_lead, &k.w_mom, &k.w_home, &k.home_adv};
+  const char *p = arg;
+  for (float *d : dst) {
+    char *end = nullptr;
+    *d = std::strtof(p, &end);
+    if (end == p) return false;
+    p = *end == ',' ? end + 1 : end;
+  }
+  return *p == '\0';
+}
+
+template <class F>
+double ns_per_state(std::size_t n, int reps, F &&f) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < reps; ++r) f();
+  double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return secs * 1e9 / (double(n) * reps);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<std::string> files, csvs;
+  std::vector<sim::LogitCoefs> sets;
+  int reps = 20;
+  for (int i = 1; i < argc; ++i) {
+    sim::LogitCoefs k;
+    if      (!std::strcmp(argv[i], "--file")  && i + 1 < argc) files.push_back(argv[++i]);
+    else if (!std::strcmp(argv[i], "--csv")   && i + 1 < argc) csvs.push_back(argv[++i]);
+    else if (!std::strcmp(argv[i], "--reps")  && i + 1 < argc) reps = std::max(1, std::atoi(argv[++i]));
+    else if (!std::strcmp(argv[i], "--coefs") && i + 1 < argc && parse_coefs(argv[++i], k)) sets.push_back(k);
+    else {
+      std::fprintf(stderr, "usage: %s [--file GAME]... [--csv F]... [--coefs w_lead,w_mom,w_home,home_adv]... [--reps N]\n",
+                   argv[0]);
+      return 2;
+    }
+  }
+  if (files.empty() && csvs.empty()) files.push_back("trading/Data/example-game.json");
+  if (sets.empty()) sets.push_back(sim::LogitCoefs{});
+
+  States st;
+  try {
+    for (const std::string &f : files) states_from_game(sim::load_game(f), st);
+    for (const std::string &f : csvs) if (!states_from_csv(f, st)) return 1;
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  // A CSV with home_adv mixed with game states: fill the rest from the set.
+  if (!st.home_adv.empty() && st.home_adv.size() != st.lead.size()) st.home_adv.clear();
+
+  const sim::WinProbInputs in = st.inputs();
+  const std::size_t n = in.size();
+  if (n == 0) { std::fprintf(stderr, "no states\n"); return 1; }
+  std::vector<float> batch(n), ref(n);
+
+  std::printf("%zu states  kernel %s\n", n, sim::win_prob_kernel_name());
+  std::printf("%-32s %10s %12s %12s %12s\n", "coefs (lead,mom,home,adv)", "mean p", "max |diff|", "batch ns", "scalar ns");
+  for (const sim::LogitCoefs &k : sets) {
+    double batch_ns = ns_per_state(n, reps, [&] { sim::win_prob_batch(k, in, batch); });
+    double scalar_ns = ns_per_state(n, reps, [&] {
+      for (std::size_t i = 0; i < n; ++i)
+        ref[i] = sim::win_prob_scalar(k, in.lead[i], in.momentum[i], in.t_rem[i],
+                                      in.home_adv.empty() ? k.home_adv : in.home_adv[i]);
+    });
+    double sum = 0.0, max_diff = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+      sum += batch[i];
+      max_diff = std::max(max_diff, double(std::fabs(batch[i] - ref[i])));
+    }
+    char label[64];
+    std::snprintf(label, sizeof label, "%g,%g,%g,%g", k.w_lead, k.w_mom, k.w_home, k.home_adv);
+    std::printf("%-32s %10.5f %12.2e %12.2f %12.2f\n", label, sum / double(n), max_diff, batch_ns, scalar_ns);
+  }
+  return 0;
+}
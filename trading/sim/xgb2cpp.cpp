@@ -0,0 +1,134 @@
+// ---- xgb2cpp.cpp (XGBoost JSON model -> constexpr C++ header) -----------------
+// Compiles a saved XGBoost model into a header of flat TreeNode arrays for
+// TreeFairValue<Model>. Feature names map to strategy inputs (lead, momentum,
+// t_rem, home_adv and the windowed RollingFeatures: run, home_pts, away_pts,
+// home_fouls, away_fouls, home_tov, away_tov, home_3pm, away_3pm); any other
+// name is fed NaN and follows the default branch.
+// The model should predict the home win probability: binary:logistic or
+// reg:logistic output goes through the sigmoid, other objectives are used as is.
+//
+//   g++ -std=c++20 -O2 -o xgb2cpp trading/sim/xgb2cpp.cpp trading/sim/engine_api.cpp
+//   ./xgb2cpp model.json trading/fair_value_model.hpp --name FairValueModel --bench 100000
+//
+// Then, after kwokker_algo.hpp (or pasted below it in the sandbox):
+//   #include "fair_value_model.hpp"
+//   class Strategy : public BasicStrategy<StrategyTypes::Cfg, TreeFairValue<FairValueModel>> { ... };
+#include "xgb_model.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char *feature_enum(StrategyTypes::Feature f) {
+  for (const sim::FeatureName &n : sim::kFeatureNames)
+    if (n.feature == f) return n.enumerator;
+  return "MISSING";
+}
+
+// Round-trippable float literal: "%.9g" plus a '.' when it prints as an integer.
+std::string float_lit(float v) {
+  char buf[32];
+  std::snprintf(buf, sizeof buf, "%.9g", double(v));
+  std::string s = buf;
+  if (s.find_first_of(".e") == std::string::npos) s += ".0";
+  return s + "f";
+}
+
+void write_header(const sim::FlatForest &f, const std::string &name, const std::string &src, std::FILE *out) {
+  std::fprintf(out, "// ---- generated by xgb2cpp from %s; do not edit ----\n", src.c_str());
+  std::fprintf(out, "// %zu trees, %zu nodes, objective %s. Include after kwokker_algo.hpp.\n",
+               f.roots.size(), f.nodes.size(), f.objective.empty() ? "?" : f.objective.c_str());
+  std::fprintf(out, "#pragma once\n\n#include <cstddef>\n#include <cstdint>\n\n");
+  std::fprintf(out, "struct %s {\n", name.c_str());
+  std::fprintf(out, "  static constexpr int kFeatures = %zu;\n", f.inputs.size());
+  std::fprintf(out, "  static constexpr StrategyTypes::Feature kInputs[kFeatures] = {\n");
+  for (std::size_t i = 0; i < f.inputs.size(); ++i)
+    std::fprintf(out, "    StrategyTypes::Feature::%s,   // %s\n", feature_enum(f.inputs[i]), f.feature_names[i].c_str());
+  std::fprintf(out, "  };\n");
+  std::fprintf(out, "  static constexpr bool  kLogistic = %s;\n", f.logistic ? "true" : "false");
+  std::fprintf(out, "  static constexpr float kBaseMargin = %s;\n", float_lit(f.base_margin).c_str());
+  std::fprintf(out, "  static constexpr std::size_t kTrees = %zu;\n", f.roots.size());
+  std::fprintf(out, "  static constexpr std::uint32_t kRoots[kTrees] = {");
+  for (std::size_t i = 0; i < f.roots.size(); ++i)
+    std::fprintf(out, "%s%u", i == 0 ? "\n    " : i % 16 ? ", " : ",\n    ", f.roots[i]);
+  std::fprintf(out, "\n  };\n");
+  std::fprintf(out, "  // {value, feature, default_left, leaf, left}\n");
+  std::fprintf(out, "  static constexpr StrategyTypes::TreeNode kNodes[%zu] = {\n", f.nodes.size());
+  for (const StrategyTypes::TreeNode &n : f.nodes)
+    std::fprintf(out, "    {%s, %u, %u, %u, %u},\n", float_lit(n.value).c_str(), unsigned(n.feature), unsigned(n.default_left),
+                 unsigned(n.leaf), n.left);
+  std::fprintf(out, "  };\n};\n");
+}
+
+// Random inputs in the ranges the strategy feeds: evaluate and time.
+void bench(const sim::FlatForest &f, int n) {
+  std::vector<float> xs(std::size_t(n) * f.inputs.size());
+  std::uint64_t s = 0x9E3779B97F4A7C15ull;
+  auto uni = [&s] { s ^= s << 13; s ^= s >> 7; s ^= s << 17; return float(s >> 40) / float(1 << 24); };
+  for (std::size_t i = 0; i < xs.size(); ++i) {
+    using F = StrategyTypes::Feature;
+    switch (f.inputs[i % f.inputs.size()]) {
+      case F::LEAD:     xs[i] = uni() * 40.0f - 20.0f; break;
+      case F::MOMENTUM: xs[i] = uni() * 4.0f - 2.0f; break;
+      case F::T_REM:    xs[i] = uni() * Strategy::Cfg::GAME_LEN2; break;
+      case F::HOME_ADV: xs[i] = Strategy::Cfg::HOME_ADV_POINTS; break;
+      case F::MISSING:  xs[i] = std::numeric_limits<float>::quiet_NaN(); break;
+      default:          xs[i] = std::floor(uni() * 8.0f); break;   // windowed counts
+    }
+  }
+  double sum = 0.0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < n; ++i) sum += f.margin(&xs[std::size_t(i) * f.inputs.size()]);
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+  std::printf("bench: %d evals, %.1f ns/eval, mean margin %.6f\n", n, ns, sum / n);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string in, out, name = "FairValueModel";
+  int bench_n = 0;
+  bool ok = true;
+  for (int i = 1; i < argc && ok; ++i) {
+    if      (!std::strcmp(argv[i], "--name")  && i + 1 < argc) name = argv[++i];
+    else if (!std::strcmp(argv[i], "--bench") && i + 1 < argc) bench_n = std::max(1, std::atoi(argv[++i]));
+    else if (argv[i][0] != '-' && in.empty())  in = argv[i];
+    else if (argv[i][0] != '-' && out.empty()) out = argv[i];
+    else ok = false;
+  }
+  if (!ok || in.empty()) {
+    std::fprintf(stderr, "usage: %s <model.json> [out.hpp] [--name Struct] [--bench N]\n", argv[0]);
+    return 2;
+  }
+
+  sim::FlatForest f;
+  try {
+    f = sim::load_xgboost_json(in);
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  for (std::size_t i = 0; i < f.inputs.size(); ++i)
+    if (f.inputs[i] == StrategyTypes::Feature::MISSING)
+      std::fprintf(stderr, "warning: feature '%s' has no strategy input; it will be NaN\n", f.feature_names[i].c_str());
+  std::printf("%zu trees, %zu nodes, %zu features, objective %s\n", f.roots.size(), f.nodes.size(), f.inputs.size(),
+              f.objective.c_str());
+
+  if (!out.empty()) {
+    std::FILE *fp = std::fopen(out.c_str(), "w");
+    if (!fp) { std::fprintf(stderr, "cannot create %s\n", out.c_str()); return 1; }
+    write_header(f, name, in, fp);
+    if (std::fclose(fp) != 0) { std::fprintf(stderr, "short write to %s\n", out.c_str()); return 1; }
+    std::printf("wrote %s (struct %s)\n", out.c_str(), name.c_str());
+  }
+  if (bench_n) bench(f, bench_n);
+  return 0;
+}
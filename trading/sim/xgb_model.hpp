@@ -0,0 +1,234 @@
+// ---- xgb_model.hpp (XGBoost JSON model -> flat tree array) --------------------
+// Reads a model saved with Booster.save_model("model.json") / XGBModel.save_model
+// and re-lays every tree breadth-first into StrategyTypes::TreeNode, the
+// layout StrategyTypes::forest_sum() walks. Used offline by xgb2cpp; the
+// strategy only ever sees the generated constexpr arrays.
+#pragma once
+
+#include "mapped_file.hpp"
+#include "strategy.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sim {
+
+// ───────── Minimal JSON ─────────
+// Just enough DOM for a model file: numbers as double, no \u escapes.
+struct Json {
+  enum class Kind : std::uint8_t { NUL, BOOL, NUM, STR, ARR, OBJ } kind = Kind::NUL;
+  double num = 0.0;
+  std::string str;
+  std::vector<Json> arr;
+  std::map<std::string, Json, std::less<>> obj;
+
+  const Json *get(std::string_view key) const {
+    auto it = obj.find(key);
+    return it == obj.end() ? nullptr : &it->second;
+  }
+  // Numbers, bools and numeric strings ("5E-1", "[5E-1]") all read as double.
+  double as_num() const {
+    if (kind == Kind::NUM || kind == Kind::BOOL) return num;
+    std::string_view s = str;
+    while (!s.empty() && (s.front() == '[' || s.front() == ' ')) s.remove_prefix(1);
+    double d = 0.0;
+    if (kind != Kind::STR || std::from_chars(s.data(), s.data() + s.size(), d).ec != std::errc{})
+      throw std::runtime_error("xgboost json: expected a number");
+    return d;
+  }
+};
+
+class JsonParser {
+public:
+  explicit JsonParser(std::string_view text) : p_(text.data()), end_(text.data() + text.size()) {}
+
+  Json parse() {
+    Json v = value_();
+    ws_();
+    if (p_ != end_) fail_("trailing data");
+    return v;
+  }
+
+private:
+  [[noreturn]] void fail_(const char *what) const { throw std::runtime_error(std::string("xgboost json: ") + what); }
+  void ws_() { while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_; }
+  bool eat_(char c) { ws_(); if (p_ < end_ && *p_ == c) { ++p_; return true; } return false; }
+  bool word_(std::string_view w) {
+    if (std::size_t(end_ - p_) < w.size() || std::string_view(p_, w.size()) != w) return false;
+    p_ += w.size();
+    return true;
+  }
+
+  std::string string_() {
+    if (!eat_('"')) fail_("expected string");
+    std::string out;
+    while (p_ < end_ && *p_ != '"') {
+      if (*p_ == '\\' && p_ + 1 < end_) ++p_;
+      out += *p_++;
+    }
+    if (p_++ >= end_) fail_("unterminated string");
+    return out;
+  }
+
+  Json value_() {
+    Json v;
+    ws_();
+    if (p_ >= end_) fail_("unexpected end");
+    switch (*p_) {
+      case '{':
+        ++p_;
+        v.kind = Json::Kind::OBJ;
+        if (eat_('}')) return v;
+        do {
+          std::string k = string_();
+          if (!eat_(':')) fail_("expected ':'");
+          v.obj.emplace(std::move(k), value_());
+        } while (eat_(','));
+        if (!eat_('}')) fail_("expected '}'");
+        return v;
+      case '[':
+        ++p_;
+        v.kind = Json::Kind::ARR;
+        if (eat_(']')) return v;
+        do v.arr.push_back(value_()); while (eat_(','));
+        if (!eat_(']')) fail_("expected ']'");
+        return v;
+      case '"':
+        v.kind = Json::Kind::STR;
+        v.str = string_();
+        return v;
+      default:
+        if (word_("null")) return v;
+        if (word_("true"))  { v.kind = Json::Kind::BOOL; v.num = 1.0; return v; }
+        if (word_("false")) { v.kind = Json::Kind::BOOL; v.num = 0.0; return v; }
+        v.kind = Json::Kind::NUM;
+        auto r = std::from_chars(p_, end_, v.num);
+        if (r.ec != std::errc{}) fail_("bad number");
+        p_ = r.ptr;
+        return v;
+    }
+  }
+
+  const char *p_;
+  const char *end_;
+};
+
+// ───────── Flat forest ─────────
+struct FlatForest {
+  std::vector<std::string>             feature_names;
+  std::vector<StrategyTypes::Feature>  inputs;      // strategy source per feature
+  std::vector<StrategyTypes::TreeNode> nodes;
+  std::vector<std::uint32_t>           roots;
+  float       base_margin = 0.0f;
+  bool        logistic = false;
+  std::string objective;
+
+  float margin(const float *x) const {
+    return base_margin + StrategyTypes::forest_sum(nodes.data(), roots.data(), roots.size(), x);
+  }
+};
+
+// Model feature names the strategy can feed, with their enumerator spelling.
+struct FeatureName {
+  StrategyTypes::Feature feature;
+  const char            *name, *enumerator;
+};
+inline constexpr FeatureName kFeatureNames[] = {
+  {StrategyTypes::Feature::LEAD,       "lead",       "LEAD"},
+  {StrategyTypes::Feature::MOMENTUM,   "momentum",   "MOMENTUM"},
+  {StrategyTypes::Feature::T_REM,      "t_rem",      "T_REM"},
+  {StrategyTypes::Feature::HOME_ADV,   "home_adv",   "HOME_ADV"},
+  {StrategyTypes::Feature::RUN,        "run",        "RUN"},
+  {StrategyTypes::Feature::HOME_PTS,   "home_pts",   "HOME_PTS"},
+  {StrategyTypes::Feature::AWAY_PTS,   "away_pts",   "AWAY_PTS"},
+  {StrategyTypes::Feature::HOME_FOULS, "home_fouls", "HOME_FOULS"},
+  {StrategyTypes::Feature::AWAY_FOULS, "away_fouls", "AWAY_FOULS"},
+  {StrategyTypes::Feature::HOME_TOV,   "home_tov",   "HOME_TOV"},
+  {StrategyTypes::Feature::AWAY_TOV,   "away_tov",   "AWAY_TOV"},
+  {StrategyTypes::Feature::HOME_3PM,   "home_3pm",   "HOME_3PM"},
+  {StrategyTypes::Feature::AWAY_3PM,   "away_3pm",   "AWAY_3PM"},
+};
+
+// Strategy-side meaning of a model feature name; MISSING if it has none.
+inline StrategyTypes::Feature feature_from_name(std::string_view n) {
+  for (const FeatureName &f : kFeatureNames)
+    if (n == f.name) return f.feature;
+  return StrategyTypes::Feature::MISSING;
+}
+
+inline FlatForest load_xgboost_json(const std::string &path) {
+  MappedFile file(path);
+  Json root = JsonParser(file.view()).parse();
+  auto need = [](const Json *j, const char *what) -> const Json & {
+    if (!j) throw std::runtime_error(std::string("xgboost json: missing ") + what);
+    return *j;
+  };
+  const Json &learner = need(root.get("learner"), "learner");
+  const Json &mparam  = need(learner.get("learner_model_param"), "learner_model_param");
+  const Json &booster = need(learner.get("gradient_booster"), "gradient_booster");
+  const Json *gbtree  = booster.get("model");
+  if (!gbtree) gbtree = booster.get("gbtree") ? booster.get("gbtree")->get("model") : nullptr;   // dart
+  const Json &trees   = need(gbtree ? gbtree->get("trees") : nullptr, "trees");
+
+  FlatForest f;
+  if (const Json *obj = learner.get("objective")) f.objective = need(obj->get("name"), "objective name").str;
+  f.logistic = f.objective == "binary:logistic" || f.objective == "reg:logistic";
+
+  if (const Json *nc = mparam.get("num_class"); nc && nc->as_num() > 1.0)
+    throw std::runtime_error("xgboost json: multi-class models are not supported");
+  std::size_t n_features = std::size_t(need(mparam.get("num_feature"), "num_feature").as_num());
+  const Json *names = learner.get("feature_names");
+  for (std::size_t i = 0; i < n_features; ++i) {
+    f.feature_names.push_back(names && i < names->arr.size() ? names->arr[i].str : "f" + std::to_string(i));
+    f.inputs.push_back(feature_from_name(f.feature_names.back()));
+  }
+  if (n_features == 0) throw std::runtime_error("xgboost json: model has no features");
+
+  // base_score is in output space; the trees add to the margin.
+  double base = need(mparam.get("base_score"), "base_score").as_num();
+  f.base_margin = float(f.logistic ? std::log(base / (1.0 - base)) : base);
+
+  for (const Json &t : trees.arr) {
+    const auto &lc = need(t.get("left_children"), "left_children").arr;
+    const auto &rc = need(t.get("right_children"), "right_children").arr;
+    const auto &si = need(t.get("split_indices"), "split_indices").arr;
+    const auto &sc = need(t.get("split_conditions"), "split_conditions").arr;
+    const auto &dl = need(t.get("default_left"), "default_left").arr;
+    if (lc.empty() || rc.size() != lc.size() || si.size() != lc.size() || sc.size() != lc.size() || dl.size() != lc.size())
+      throw std::runtime_error("xgboost json: malformed tree");
+
+    // Breadth-first relayout: each split's children get consecutive slots.
+    std::vector<std::uint32_t> order{0};
+    std::uint32_t base_slot = std::uint32_t(f.nodes.size());
+    f.roots.push_back(base_slot);
+    f.nodes.push_back({});
+    for (std::size_t q = 0; q < order.size(); ++q) {
+      std::uint32_t src = order[q];
+      StrategyTypes::TreeNode &nd = f.nodes[base_slot + q];
+      int l = int(lc[src].as_num()), r = int(rc[src].as_num());
+      nd.value = float(sc[src].as_num());
+      if (l < 0) { nd.leaf = 1; nd.feature = 0; nd.default_left = 0; nd.left = 0; continue; }
+      if (std::size_t(l) >= lc.size() || std::size_t(r) >= lc.size() || order.size() + 2 > lc.size())
+        throw std::runtime_error("xgboost json: bad child index");
+      std::size_t feat = std::size_t(si[src].as_num());
+      if (feat >= n_features) throw std::runtime_error("xgboost json: split on unknown feature");
+      nd.leaf = 0;
+      nd.feature = std::uint16_t(feat);
+      nd.default_left = dl[src].as_num() != 0.0 ? 1 : 0;
+      nd.left = base_slot + std::uint32_t(order.size());
+      order.push_back(std::uint32_t(l));
+      order.push_back(std::uint32_t(r));
+      f.nodes.push_back({});
+      f.nodes.push_back({});
+    }
+  }
+  return f;
+}
+
+} // namespace sim